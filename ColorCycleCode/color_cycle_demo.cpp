@@ -8,6 +8,9 @@
 #include <SDL.h>
 
 #include <cmath>
+#include <iostream>
+
+#include "../intermediateLessons/includes/frame_limiter.hpp"
 
 void moveRectangle(SDL_Rect& rect, int& dx, int& dy, int screenW = 800, int screenH = 600) {
     if (rect.x < 0 || rect.x + rect.w > screenW)
@@ -28,9 +31,10 @@ int main() {
 
     SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, 0);
 
-    bool      running = true;
-    SDL_Event e;
-    int       frame = 0;
+    bool         running = true;
+    SDL_Event    e;
+    int          frame = 0;
+    FrameLimiter limiter;
 
     SDL_Rect rect = {350, 250, 100, 100};
     int      dx = 2;
@@ -72,9 +76,10 @@ int main() {
         // 4️⃣ Present final image to screen
         SDL_RenderPresent(renderer);
 
-        SDL_Delay(16);
+        limiter.wait();
         frame++;
     }
+    limiter.report(std::cout);
 
     SDL_Quit();
     return 0;
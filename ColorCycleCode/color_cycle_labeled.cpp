@@ -11,8 +11,11 @@
 #include <SDL_ttf.h>
 
 #include <cmath>
+#include <iostream>
 #include <string>
 
+#include "../intermediateLessons/includes/frame_limiter.hpp"
+
 // Small helper to draw a single line of text
 void drawText(SDL_Renderer* renderer, TTF_Font* font,
               const std::string& msg, int x, int y, SDL_Color color) {
@@ -36,9 +39,10 @@ int main() {
     TTF_Font* font = TTF_OpenFont("/System/Library/Fonts/Supplemental/Arial.ttf", 24);
     if (!font) font = TTF_OpenFont("DejaVuSans.ttf", 24);  // fallback for Linux
 
-    bool      running = true;
-    SDL_Event e;
-    int       frame = 0;
+    bool         running = true;
+    SDL_Event    e;
+    int          frame = 0;
+    FrameLimiter limiter;
 
     while (running) {
         while (SDL_PollEvent(&e)) {
@@ -78,10 +82,12 @@ int main() {
         // Present to screen
         // ------------------------------
         SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        limiter.wait();
         frame++;
     }
 
+    limiter.report(std::cout);
+
     // Cleanup
     TTF_CloseFont(font);
     TTF_Quit();
@@ -8,9 +8,13 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 
+#include <iostream>
 #include <sstream>
 #include <string>
 
+#include "../intermediateLessons/includes/frame_limiter.hpp"
+#include "../intermediateLessons/includes/input_latency.hpp"
+
 int main() {
     SDL_Init(SDL_INIT_VIDEO);
     TTF_Init();
@@ -29,6 +33,9 @@ int main() {
     int       cellSize = 40;
     int       clickX = -1, clickY = -1;
 
+    InputLatencyTracker clicks;  // click -> first frame showing it
+    FrameLimiter        limiter;
+
     while (running) {
         // 1️⃣ Event handling
         while (SDL_PollEvent(&e)) {
@@ -37,6 +44,7 @@ int main() {
             else if (e.type == SDL_MOUSEBUTTONDOWN) {
                 clickX = e.button.x;
                 clickY = e.button.y;
+                clicks.onClick(e.button.timestamp);
             }
         }
 
@@ -54,7 +62,7 @@ int main() {
         // 4️⃣ Draw mouse coordinates (if clicked)
         if (clickX >= 0 && clickY >= 0) {
             std::ostringstream oss;
-            oss << "(" << clickX << ", " << clickY << ")";
+            oss << "(" << clickX << ", " << clickY << ")  " << clicks.label();
             std::string text = oss.str();
 
             SDL_Color    white = {255, 255, 255, 255};
@@ -73,9 +81,12 @@ int main() {
 
         // 5️⃣ Present
         SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        clicks.onPresent();
+        limiter.wait();
     }
 
+    clicks.print(std::cout);
+    limiter.report(std::cout);
     TTF_CloseFont(font);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -8,9 +8,13 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 
+#include <iostream>
 #include <sstream>
 #include <string>
 
+#include "../intermediateLessons/includes/frame_limiter.hpp"
+#include "../intermediateLessons/includes/input_latency.hpp"
+
 int main() {
     SDL_Init(SDL_INIT_VIDEO);
     TTF_Init();
@@ -34,6 +38,9 @@ int main() {
     int clickedRow = -1;
     int clickedCol = -1;
 
+    InputLatencyTracker clicks;  // click -> first frame showing it
+    FrameLimiter        limiter;
+
     bool      running = true;
     SDL_Event e;
 
@@ -51,6 +58,7 @@ int main() {
                 // Convert pixel coordinates to grid coordinates
                 clickedCol = mouseX / cellSize;
                 clickedRow = mouseY / cellSize;
+                clicks.onClick(e.button.timestamp);
             }
         }
 
@@ -87,7 +95,7 @@ int main() {
         // ---------------------------------------------------------
         if (clickedRow >= 0 && clickedCol >= 0) {
             std::ostringstream oss;
-            oss << "[col=" << clickedCol << ", row=" << clickedRow << "]";
+            oss << "[col=" << clickedCol << ", row=" << clickedRow << "]  " << clicks.label();
             std::string text = oss.str();
 
             SDL_Color    white = {255, 255, 255, 255};
@@ -107,9 +115,12 @@ int main() {
         // 6️⃣ PRESENT FRAME
         // ---------------------------------------------------------
         SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        clicks.onPresent();
+        limiter.wait();
     }
 
+    clicks.print(std::cout);
+    limiter.report(std::cout);
     TTF_CloseFont(font);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
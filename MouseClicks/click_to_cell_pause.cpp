@@ -7,10 +7,14 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 
+#include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "../intermediateLessons/includes/frame_limiter.hpp"
+#include "../intermediateLessons/includes/input_latency.hpp"
+
 int main() {
     SDL_Init(SDL_INIT_VIDEO);
     TTF_Init();
@@ -36,6 +40,9 @@ int main() {
     bool      running = true;
     SDL_Event e;
 
+    InputLatencyTracker clicks;  // click -> first frame showing it
+    FrameLimiter        limiter;
+
     while (running) {
         // ---------------------------------------------------------
         // 1️⃣ HANDLE EVENTS
@@ -53,6 +60,7 @@ int main() {
                 if (clickedRow >= 0 && clickedRow < rows &&
                     clickedCol >= 0 && clickedCol < cols) {
                     cells[clickedRow][clickedCol] = !cells[clickedRow][clickedCol];
+                    clicks.onClick(e.button.timestamp);
                 }
             }
 
@@ -97,7 +105,7 @@ int main() {
         oss << (paused ? "[PAUSED]" : "[RUNNING]");
         if (clickedRow >= 0 && clickedCol >= 0)
             oss << "  col=" << clickedCol << ", row=" << clickedRow
-                << " (" << (cells[clickedRow][clickedCol] ? "Alive" : "Dead") << ")";
+                << " (" << (cells[clickedRow][clickedCol] ? "Alive" : "Dead") << ")  " << clicks.label();
 
         SDL_Surface* surf = TTF_RenderText_Solid(font, oss.str().c_str(), white);
         SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
@@ -113,10 +121,13 @@ int main() {
         // 6️⃣ PRESENT
         // ---------------------------------------------------------
         SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        clicks.onPresent();
+        limiter.wait();
     }
 
     // Cleanup
+    clicks.print(std::cout);
+    limiter.report(std::cout);
     TTF_CloseFont(font);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
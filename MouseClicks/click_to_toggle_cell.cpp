@@ -8,10 +8,14 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 
+#include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "../intermediateLessons/includes/frame_limiter.hpp"
+#include "../intermediateLessons/includes/input_latency.hpp"
+
 int main() {
     SDL_Init(SDL_INIT_VIDEO);
     TTF_Init();
@@ -37,6 +41,9 @@ int main() {
     int clickedRow = -1;
     int clickedCol = -1;
 
+    InputLatencyTracker clicks;  // click -> first frame showing it
+    FrameLimiter        limiter;
+
     bool      running = true;
     SDL_Event e;
 
@@ -58,6 +65,7 @@ int main() {
                 if (clickedRow >= 0 && clickedRow < rows &&
                     clickedCol >= 0 && clickedCol < cols) {
                     cells[clickedRow][clickedCol] = !cells[clickedRow][clickedCol];
+                    clicks.onClick(e.button.timestamp);
                 }
             }
         }
@@ -94,7 +102,7 @@ int main() {
         if (clickedRow >= 0 && clickedCol >= 0) {
             std::ostringstream oss;
             oss << "[col=" << clickedCol << ", row=" << clickedRow
-                << "] " << (cells[clickedRow][clickedCol] ? "Alive" : "Dead");
+                << "] " << (cells[clickedRow][clickedCol] ? "Alive" : "Dead") << "  " << clicks.label();
             std::string text = oss.str();
 
             SDL_Color    white = {255, 255, 255, 255};
@@ -114,12 +122,15 @@ int main() {
         // 6️⃣ PRESENT FRAME
         // ---------------------------------------------------------
         SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        clicks.onPresent();
+        limiter.wait();
     }
 
     // -------------------------------------------------------------
     // CLEANUP
     // -------------------------------------------------------------
+    clicks.print(std::cout);
+    limiter.report(std::cout);
     TTF_CloseFont(font);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -0,0 +1,153 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Build with -DGOL_TRACK_ALLOCS=1 to replace the global operator new / delete
+// with counting versions. Without it everything here still compiles, the counts
+// just stay at zero and the no-alloc guards do nothing.
+#ifndef GOL_TRACK_ALLOCS
+#define GOL_TRACK_ALLOCS 0
+#endif
+
+#if GOL_TRACK_ALLOCS && (defined(__GLIBC__) || defined(__APPLE__))
+#include <execinfo.h>
+#define GOL_ALLOC_BACKTRACE 1
+#endif
+
+// Heap allocation counting, per thread.
+//
+//     Alloc::Counts before = Alloc::counts();
+//     doFrameWork();
+//     Alloc::Counts used = Alloc::counts() - before;   // used.allocs, used.bytes
+//
+//     {
+//         Alloc::NoAllocScope guard("draw");   // any operator new in here is a violation
+//         drawBoard();
+//     }
+//
+// A violation prints the region name and a short stack trace to stderr (the
+// first kMaxStackDumps of them; later ones are only counted), or aborts with
+// setPolicy(Policy::Abort) so a debugger lands right on it. Link with -rdynamic
+// to get function names in the trace instead of bare addresses.
+//
+// Only C++ operator new / delete are seen, not malloc() inside SDL or the C
+// library, and only on the thread that made the call: pool workers count
+// towards their own threads. The operators are defined in this header, so it
+// can only be included by one translation unit per program, which is how all
+// the programs here are built anyway.
+namespace Alloc {
+
+struct Counts {
+    uint64_t allocs = 0, frees = 0, bytes = 0;
+
+    Counts operator-(const Counts& o) const { return {allocs - o.allocs, frees - o.frees, bytes - o.bytes}; }
+    Counts& operator+=(const Counts& o) {
+        allocs += o.allocs;
+        frees += o.frees;
+        bytes += o.bytes;
+        return *this;
+    }
+};
+
+enum class Policy { Log, Abort };
+
+constexpr int kMaxStackDumps = 8;
+
+struct ThreadState {
+    Counts      counts;
+    const char* noAlloc = nullptr;  // innermost "must not allocate" region, if any
+    bool        inHook = false;     // reporting a violation; don't count our own work
+};
+
+inline thread_local ThreadState state;
+inline std::atomic< Policy >    policy{Policy::Log};
+inline std::atomic< long >      violationCount{0};
+
+constexpr bool enabled() { return GOL_TRACK_ALLOCS != 0; }
+
+inline Counts counts() { return state.counts; }
+inline long   violations() { return violationCount.load(); }
+inline void   setPolicy(Policy p) { policy = p; }
+
+// Marks a region of code that must not allocate. Nests; a null name leaves the
+// enclosing region (if any) in force.
+class NoAllocScope {
+public:
+    explicit NoAllocScope(const char* region) : prev(state.noAlloc) {
+        if (enabled() && region) state.noAlloc = region;
+    }
+    ~NoAllocScope() { state.noAlloc = prev; }
+    NoAllocScope(const NoAllocScope&) = delete;
+    NoAllocScope& operator=(const NoAllocScope&) = delete;
+
+private:
+    const char* prev;
+};
+
+// Called from inside operator new, so nothing in here may allocate: stdio to the
+// unbuffered stderr and backtrace_symbols_fd() only.
+inline void reportViolation(std::size_t size) {
+    state.inHook = true;
+    long n = violationCount.fetch_add(1);
+    if (n < kMaxStackDumps || policy == Policy::Abort) {
+        std::fprintf(stderr, "alloc: %zu bytes in no-alloc region \"%s\"\n", size, state.noAlloc);
+#ifdef GOL_ALLOC_BACKTRACE
+        void* frames[16];
+        int   depth = backtrace(frames, 16);
+        backtrace_symbols_fd(frames + 2, depth - 2, 2);  // skip this function and operator new
+#endif
+        if (n == kMaxStackDumps - 1) std::fprintf(stderr, "alloc: further violations are counted, not logged\n");
+    }
+    state.inHook = false;
+    if (policy == Policy::Abort) std::abort();
+}
+
+inline void onAlloc(std::size_t size) {
+    if (state.inHook) return;
+    ++state.counts.allocs;
+    state.counts.bytes += size;
+    if (state.noAlloc) reportViolation(size);
+}
+
+inline void onFree() {
+    if (!state.inHook) ++state.counts.frees;
+}
+
+}  // namespace Alloc
+
+#if GOL_TRACK_ALLOCS
+// Replacements for the global allocation functions. The aligned (align_val_t)
+// forms are left alone; nothing in this project uses over-aligned types.
+void* operator new(std::size_t size) {
+    Alloc::onAlloc(size);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    Alloc::onAlloc(size);
+    return std::malloc(size ? size : 1);
+}
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return ::operator new(size, tag); }
+
+// GCC sees free() on memory from an inlined operator new and warns about a
+// mismatch; these replacements are the allocator, so the pairing is right.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept {
+    if (p) Alloc::onFree();
+    std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+#include <SDL.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+// Paces a game loop to a fixed frame time.
+//
+// SDL_Delay(16) sleeps a whole number of milliseconds *on top of* however long the
+// frame already took, so the real frame time wanders around 16ms + work. This class
+// keeps an absolute deadline per frame instead: it sleeps for the bulk of whatever
+// is left of the budget, then spin-waits the final stretch on the high resolution
+// performance counter so the loop wakes up right on time.
+//
+// With vsync on, SDL_RenderPresent already blocks until the display refresh, so the
+// limiter only measures and never sleeps.
+class FrameLimiter {
+public:
+    explicit FrameLimiter(double fps = 60.0, bool vsync = false, double spinMs = 2.0)
+        : freq(SDL_GetPerformanceFrequency()),
+          vsync(vsync),
+          spinTicks(toTicks(spinMs)),
+          lateTicks(toTicks(0.25)) {
+        setTargetFps(fps);
+    }
+
+    void setTargetFps(double fps) {
+        fps = std::max(1.0, fps);
+        periodTicks = toTicks(1000.0 / fps);
+    }
+
+    void setVsync(bool on) { vsync = on; }
+
+    // Call once per frame, right after SDL_RenderPresent().
+    void wait() {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (!started) {
+            started = true;
+            deadline = now + periodTicks;
+            last = now;
+            if (vsync) return;
+        }
+
+        if (!vsync) {
+            if (deadline > now + spinTicks + oversleep) {
+                Uint32 sleepMs = Uint32(toMs(deadline - now - spinTicks - oversleep));
+                if (sleepMs > 0) {
+                    Uint64 before = SDL_GetPerformanceCounter();
+                    SDL_Delay(sleepMs);
+                    learnOversleep(SDL_GetPerformanceCounter() - before, toTicks(sleepMs));
+                }
+            }
+            while ((now = SDL_GetPerformanceCounter()) < deadline) {
+            }
+            // A late frame (slow work, the scheduler, a breakpoint) starts the next
+            // period from now: catching up would follow every long frame with a
+            // short one and double the jitter.
+            deadline = std::max(deadline, now - lateTicks) + periodTicks;
+        }
+
+        record(toMs(now - last));
+        last = now;
+    }
+
+    // Milliseconds between the two most recent frames (0 before the second frame).
+    double lastFrameMs() const { return lastMs; }
+    double targetMs() const { return toMs(periodTicks); }
+    double averageMs() const { return frames ? mean : 0.0; }
+    double stddevMs() const { return frames > 1 ? std::sqrt(m2 / double(frames - 1)) : 0.0; }
+    double minMs() const { return frames ? lo : 0.0; }
+    double maxMs() const { return hi; }
+    long   frameCount() const { return frames; }
+
+    void reset() {
+        frames = 0;
+        mean = m2 = hi = 0.0;
+        lo = 1e300;
+    }
+
+    void report(std::ostream& os) const {
+        os << std::fixed << std::setprecision(3)
+           << "Frame pacing (" << (vsync ? "vsync" : "sleep+spin") << "): "
+           << "target " << targetMs() << " ms, achieved avg " << averageMs()
+           << " ms, stddev " << stddevMs() << " ms, min " << minMs()
+           << " ms, max " << maxMs() << " ms over " << frames << " frames\n";
+    }
+
+private:
+    Uint64 freq;
+    bool   vsync;
+    Uint64 spinTicks;
+    Uint64 lateTicks;  // later than this past the deadline restarts the schedule
+    Uint64 periodTicks = 0;
+    Uint64 deadline = 0, last = 0;
+    Uint64 oversleep = 0;  // how late SDL_Delay has been waking up lately
+    bool   started = false;
+
+    // Running stats (Welford) over the measured frame intervals.
+    long   frames = 0;
+    double lastMs = 0.0, mean = 0.0, m2 = 0.0, lo = 1e300, hi = 0.0;
+
+    Uint64 toTicks(double ms) const { return Uint64(ms * double(freq) / 1000.0); }
+    double toMs(Uint64 ticks) const { return double(ticks) * 1000.0 / double(freq); }
+
+    // The OS scheduler may wake us well after the requested time. Track the worst
+    // recent overshoot (slowly decaying) and start spinning that much earlier.
+    void learnOversleep(Uint64 slept, Uint64 requested) {
+        Uint64 late = slept > requested ? slept - requested : 0;
+        oversleep = std::max(late, oversleep - oversleep / 64);
+    }
+
+    void record(double ms) {
+        lastMs = ms;
+        ++frames;
+        double delta = ms - mean;
+        mean += delta / double(frames);
+        m2 += delta * (ms - mean);
+        lo = std::min(lo, ms);
+        hi = std::max(hi, ms);
+    }
+};
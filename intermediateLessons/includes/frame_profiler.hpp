@@ -0,0 +1,312 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The parts of one trip around the game loop that we time separately.
+enum class Phase { Events, Update, Draw, Hud, Present, Count };
+
+inline const char* phaseName(Phase p) {
+    switch (p) {
+        case Phase::Events: return "events";
+        case Phase::Update: return "update";
+        case Phase::Draw: return "draw";
+        case Phase::Hud: return "hud";
+        case Phase::Present: return "present";
+        default: return "?";
+    }
+}
+
+// Per-phase frame timer.
+//
+//     prof.beginFrame();
+//     { auto t = prof.scope(Phase::Update); grid.update(); }
+//     ...
+//     prof.endFrame();
+//
+// Keeps a rolling window of the last kWindow frames per phase (min / avg / p99),
+// can draw those numbers as an overlay, and can stream one CSV row per frame.
+// Extra per-frame numbers (hardware counter ratios, say) can ride along as
+// metrics: averaged under the phases in the overlay, extra columns in the CSV.
+//
+// Everything is behind `if constexpr (Enabled)`, so FrameProfiler<false> compiles
+// down to nothing: the scopes do not even read the clock.
+template < bool Enabled >
+class FrameProfiler {
+public:
+    static constexpr int kPhases = int(Phase::Count);
+    static constexpr int kWindow = 240;  // ~4 seconds at 60 fps
+    static constexpr int kRefresh = 15;  // frames between stats/HUD refreshes
+    static constexpr int kTextW = 340;   // HUD text column width in pixels
+
+    struct Stats {
+        double min = 0.0, avg = 0.0, p99 = 0.0;  // milliseconds
+    };
+
+    class Scope {
+    public:
+        Scope(FrameProfiler& p, Phase ph) : prof(p), phase(ph) {
+            if constexpr (Enabled) start = SDL_GetPerformanceCounter();
+        }
+        ~Scope() {
+            if constexpr (Enabled) prof.add(phase, SDL_GetPerformanceCounter() - start);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler& prof;
+        Phase          phase;
+        Uint64         start = 0;
+    };
+
+    FrameProfiler() : freq(double(SDL_GetPerformanceFrequency())) {}
+
+    // The HUD texture belongs to the renderer: release() it before destroying that.
+    ~FrameProfiler() {
+        if constexpr (Enabled) {
+            release();
+            if (font) TTF_CloseFont(font);
+            if (ownsTtf) TTF_Quit();
+        }
+    }
+
+    static constexpr bool enabled() { return Enabled; }
+
+    // Frees the HUD texture; the next drawHud() makes a new one.
+    void release() {
+        if constexpr (Enabled) {
+            if (hudTex) SDL_DestroyTexture(hudTex);
+            hudTex = nullptr;
+            hudDirty = true;
+        }
+    }
+
+    Scope scope(Phase p) { return Scope(*this, p); }
+
+    // Adds ticks to a phase of the current frame. Scopes call this for you.
+    void add(Phase p, Uint64 ticks) {
+        if constexpr (Enabled) current[int(p)] += ticks;
+    }
+
+    // Registers an extra per-frame number and returns its id for metric(). Do it
+    // before openCsv() so the column makes it into the header.
+    int addMetric(const std::string& name) {
+        if constexpr (Enabled) {
+            metricNames.push_back(name);
+            metricNow.push_back(NAN);
+            metricHistory.emplace_back();
+            metricHistory.back().fill(NAN);
+            metricAvg.push_back(NAN);
+            hudDirty = true;
+            return int(metricNames.size()) - 1;
+        }
+        return -1;
+    }
+
+    // Sets a metric for the current frame. Frames that don't set it (e.g. no
+    // update while paused) leave a gap rather than a zero.
+    void metric(int id, double value) {
+        if constexpr (Enabled)
+            if (id >= 0 && id < int(metricNow.size())) metricNow[id] = value;
+    }
+
+    double metricAverage(int id) const { return id >= 0 && id < int(metricAvg.size()) ? metricAvg[id] : NAN; }
+
+    // Streams one row per frame to `path`. Returns false if the file can't be opened.
+    bool openCsv(const std::string& path) {
+        if constexpr (Enabled) {
+            csv.open(path);
+            if (!csv) return false;
+            csv << "frame";
+            for (int p = 0; p < kPhases; ++p) csv << ',' << phaseName(Phase(p)) << "_ms";
+            csv << ",work_ms";
+            for (auto& name : metricNames) csv << ',' << name;
+            csv << '\n';
+            csv << std::fixed << std::setprecision(4);
+            return true;
+        }
+        return false;
+    }
+
+    void beginFrame() {
+        if constexpr (Enabled) {
+            current.fill(0);
+            std::fill(metricNow.begin(), metricNow.end(), NAN);
+        }
+    }
+
+    void endFrame() {
+        if constexpr (Enabled) {
+            int    slot = int(frame % kWindow);
+            double work = 0.0;
+            for (int p = 0; p < kPhases; ++p) {
+                double ms = double(current[p]) * 1000.0 / freq;
+                history[p][slot] = ms;
+                work += ms;
+            }
+            for (size_t m = 0; m < metricNow.size(); ++m) metricHistory[m][slot] = metricNow[m];
+            if (csv.is_open()) {
+                csv << frame;
+                for (int p = 0; p < kPhases; ++p) csv << ',' << history[p][slot];
+                csv << ',' << work;
+                for (double v : metricNow) {
+                    csv << ',';
+                    if (!std::isnan(v)) csv << std::defaultfloat << v << std::fixed;  // 4 significant digits
+                }
+                csv << '\n';
+            }
+            ++frame;
+            if (frame % kRefresh == 0) refresh();
+        }
+    }
+
+    const Stats& stats(Phase p) const { return summary[int(p)]; }
+    long         frames() const { return frame; }
+
+    void toggleHud() {
+        if constexpr (Enabled) {
+            hudVisible = !hudVisible;
+            hudDirty = true;
+        }
+    }
+
+    // Draws the rolling stats over whatever is already on screen. Text needs
+    // SDL_ttf and a font; without one we still draw the bars.
+    void drawHud(SDL_Renderer* renderer, double budgetMs = 1000.0 / 60.0) {
+        if constexpr (Enabled) {
+            if (!hudVisible) return;
+            if (!fontTried) loadFont();
+
+            const int lineH = font ? TTF_FontLineSkip(font) : 14;
+            const int barW = 120;
+            const int lines = kPhases + int(metricNames.size());
+            SDL_Rect  panel = {8, 8, kTextW + barW + 18, lineH * lines + 12};
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 170);
+            SDL_RenderFillRect(renderer, &panel);
+
+            for (int p = 0; p < kPhases; ++p) {
+                double   frac = std::min(1.0, summary[p].avg / budgetMs);
+                SDL_Rect bar = {panel.x + panel.w - barW - 6, panel.y + 6 + p * lineH + 3,
+                                std::max(1, int(frac * barW)), lineH - 6};
+                SDL_SetRenderDrawColor(renderer, 80 + Uint8(175 * frac), Uint8(200 * (1 - frac)) + 40, 60, 255);
+                SDL_RenderFillRect(renderer, &bar);
+            }
+
+            if (font) {
+                if (hudDirty) rebuildText(renderer);
+                if (hudTex) {
+                    SDL_Rect dst = {panel.x + 6, panel.y + 6, hudW, hudH};
+                    SDL_RenderCopy(renderer, hudTex, NULL, &dst);
+                }
+            }
+        }
+    }
+
+    void setFontPath(const std::string& path) { fontPath = path; }
+
+private:
+    double freq;
+    long   frame = 0;
+
+    std::array< Uint64, kPhases >                        current{};
+    std::array< std::array< double, kWindow >, kPhases > history{};
+    std::array< Stats, kPhases >                         summary{};
+    std::ofstream                                        csv;
+
+    std::vector< std::string >                   metricNames;
+    std::vector< double >                        metricNow, metricAvg;
+    std::vector< std::array< double, kWindow > > metricHistory;
+
+    bool         hudVisible = false, hudDirty = true;
+    bool         fontTried = false, ownsTtf = false;
+    std::string  fontPath;
+    TTF_Font*    font = nullptr;
+    SDL_Texture* hudTex = nullptr;
+    int          hudW = 0, hudH = 0;
+
+    void refresh() {
+        int                           n = int(std::min< long >(frame, kWindow));
+        std::array< double, kWindow > sorted;
+        for (int p = 0; p < kPhases; ++p) {
+            std::copy(history[p].begin(), history[p].begin() + n, sorted.begin());
+            std::sort(sorted.begin(), sorted.begin() + n);
+            double sum = 0.0;
+            for (int i = 0; i < n; ++i) sum += sorted[i];
+            summary[p].min = sorted[0];
+            summary[p].avg = sum / n;
+            summary[p].p99 = sorted[std::min(n - 1, int(0.99 * n))];
+        }
+        for (size_t m = 0; m < metricNames.size(); ++m) {
+            double sum = 0.0;
+            int    seen = 0;
+            for (int i = 0; i < n; ++i)
+                if (!std::isnan(metricHistory[m][i])) {
+                    sum += metricHistory[m][i];
+                    ++seen;
+                }
+            metricAvg[m] = seen ? sum / seen : NAN;
+        }
+        hudDirty = true;
+    }
+
+    void loadFont() {
+        fontTried = true;
+        if (!TTF_WasInit()) {
+            if (TTF_Init() != 0) return;
+            ownsTtf = true;
+        }
+        const char* candidates[] = {
+            fontPath.c_str(),
+            "/System/Library/Fonts/Menlo.ttc",
+            "/System/Library/Fonts/Supplemental/Arial.ttf",
+            "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+            "DejaVuSansMono.ttf",
+            "DejaVuSans.ttf"};
+        for (const char* path : candidates)
+            if (*path && (font = TTF_OpenFont(path, 14))) break;
+    }
+
+    void rebuildText(SDL_Renderer* renderer) {
+        hudDirty = false;
+        if (hudTex) SDL_DestroyTexture(hudTex);
+        hudTex = nullptr;
+
+        // One texture for the whole block of text, rebuilt every kRefresh frames.
+        const int    lineH = TTF_FontLineSkip(font);
+        const int    lines = kPhases + int(metricNames.size());
+        SDL_Surface* block = SDL_CreateRGBSurfaceWithFormat(0, kTextW, lineH * lines, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!block) return;
+        SDL_Color white = {235, 235, 235, 255};
+        for (int i = 0; i < lines; ++i) {
+            std::ostringstream oss;
+            if (i < kPhases)
+                oss << std::left << std::setw(8) << phaseName(Phase(i)) << std::right << std::fixed
+                    << std::setprecision(2) << " min " << summary[i].min << "  avg " << summary[i].avg
+                    << "  p99 " << summary[i].p99;
+            else if (std::isnan(metricAvg[i - kPhases]))
+                oss << std::left << std::setw(26) << metricNames[i - kPhases] << " -";
+            else
+                oss << std::left << std::setw(26) << metricNames[i - kPhases] << ' '
+                    << std::setprecision(3) << metricAvg[i - kPhases];
+            SDL_Surface* line = TTF_RenderText_Blended(font, oss.str().c_str(), white);
+            if (!line) continue;
+            SDL_Rect dst = {0, i * lineH, line->w, line->h};
+            SDL_BlitSurface(line, NULL, block, &dst);
+            SDL_FreeSurface(line);
+        }
+        hudTex = SDL_CreateTextureFromSurface(renderer, block);
+        hudW = block->w;
+        hudH = block->h;
+        SDL_FreeSurface(block);
+    }
+};
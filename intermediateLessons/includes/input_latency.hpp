@@ -0,0 +1,97 @@
+#pragma once
+#include <SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Click-to-photon latency: from the moment SDL stamped a mouse click to the
+// SDL_RenderPresent() that first shows its effect.
+//
+//     case SDL_MOUSEBUTTONDOWN: toggle(...); clicks.onClick(e.button.timestamp); break;
+//     ...
+//     SDL_RenderPresent(renderer);
+//     clicks.onPresent();
+//
+// event.button.timestamp is in SDL_GetTicks() milliseconds, so the time a click
+// sat in the queue is only known to the millisecond. From the moment we handle it
+// on, we switch to the performance counter, which makes the update -> draw ->
+// present part of the pipeline sub-millisecond accurate.
+//
+// Keeps the last kWindow samples for a rolling distribution.
+class InputLatencyTracker {
+public:
+    static constexpr int kWindow = 256;
+
+    struct Summary {
+        int    count = 0;
+        double last = 0.0, p50 = 0.0, p90 = 0.0, p99 = 0.0, max = 0.0;  // milliseconds
+    };
+
+    // Call when a click is handled (and has changed what the next frame shows).
+    void onClick(Uint32 eventTimestamp) {
+        Uint32 queuedMs = SDL_GetTicks() - eventTimestamp;
+        pending.push_back({double(queuedMs), SDL_GetPerformanceCounter()});
+    }
+
+    // Call right after SDL_RenderPresent().
+    void onPresent() {
+        if (pending.empty()) return;
+        Uint64 now = SDL_GetPerformanceCounter();
+        double freq = double(SDL_GetPerformanceFrequency());
+        for (const Pending& p : pending) {
+            double ms = p.queuedMs + double(now - p.handledAt) * 1000.0 / freq;
+            samples[next % kWindow] = ms;
+            ++next;
+            lastMs = ms;
+        }
+        pending.clear();
+    }
+
+    Summary summary() const {
+        Summary s;
+        s.count = int(std::min< long >(next, kWindow));
+        if (!s.count) return s;
+        std::array< double, kWindow > sorted;
+        std::copy(samples.begin(), samples.begin() + s.count, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + s.count);
+        auto at = [&](double q) { return sorted[std::min(s.count - 1, int(q * s.count))]; };
+        s.last = lastMs;
+        s.p50 = at(0.50);
+        s.p90 = at(0.90);
+        s.p99 = at(0.99);
+        s.max = sorted[s.count - 1];
+        return s;
+    }
+
+    // Short form for on-screen labels, e.g. "lag 9.8 ms (p90 12.1)".
+    std::string label() const {
+        Summary s = summary();
+        if (!s.count) return "";
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << "lag " << s.last << " ms (p90 " << s.p90 << ")";
+        return oss.str();
+    }
+
+    void print(std::ostream& os) const {
+        Summary s = summary();
+        os << std::fixed << std::setprecision(2) << "Click-to-present over last " << s.count
+           << " clicks: p50 " << s.p50 << "  p90 " << s.p90 << "  p99 " << s.p99 << "  max " << s.max
+           << " ms\n";
+    }
+
+private:
+    struct Pending {
+        double queuedMs;   // event timestamp -> handled, SDL_GetTicks resolution
+        Uint64 handledAt;  // performance counter when handled
+    };
+
+    std::vector< Pending >        pending;
+    std::array< double, kWindow > samples{};
+    long                          next = 0;
+    double                        lastMs = 0.0;
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "json.hpp"
+
+// High-dynamic-range histogram of durations in microseconds (HdrHistogram layout).
+//
+// Values below 128 us get one exact bucket each. Above that every power of two is
+// split into 64 linear sub-buckets, so any recorded value is off by at most 1/64
+// (~1.6%) whether it is 200 us or 20 seconds. All storage is one fixed array:
+// record() never allocates and is a couple of shifts and an increment.
+class LatencyHistogram {
+public:
+    static constexpr int      kLinear = 128;  // exact buckets for 0..127 us
+    static constexpr int      kSub = 64;      // sub-buckets per power of two above that
+    static constexpr int      kMaxExp = 40;   // 2^40 us ~ 12.7 days; larger values clamp
+    static constexpr int      kBuckets = kLinear + (kMaxExp - 7) * kSub;
+    static constexpr uint64_t kMaxValue = (uint64_t(1) << kMaxExp) - 1;
+
+    void record(uint64_t us) {
+        us = std::min(us, kMaxValue);
+        ++counts[indexOf(us)];
+        ++total;
+        sum += us;
+        lo = std::min(lo, us);
+        hi = std::max(hi, us);
+    }
+
+    void recordMs(double ms) { record(uint64_t(std::max(0.0, ms) * 1000.0 + 0.5)); }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? lo : 0; }
+    uint64_t max() const { return hi; }
+    double   mean() const { return total ? double(sum) / double(total) : 0.0; }
+
+    // Smallest recorded value such that `p` percent of samples are <= it, reported as
+    // the top of its bucket (and never more than the true maximum).
+    uint64_t percentile(double p) const {
+        if (!total) return 0;
+        uint64_t rank = uint64_t(std::max(1.0, p / 100.0 * double(total) + 0.5));
+        rank = std::min(rank, total);
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(highestEquivalent(i), hi);
+        }
+        return hi;
+    }
+
+    void reset() {
+        counts.fill(0);
+        total = sum = hi = 0;
+        lo = UINT64_MAX;
+    }
+
+    void print(std::ostream& os, const std::string& label) const {
+        os << std::left << std::setw(12) << label << std::right << std::fixed << std::setprecision(3)
+           << " n=" << std::setw(7) << total;
+        const std::pair< const char*, double > marks[] = {{"p50", 50}, {"p90", 90}, {"p99", 99}, {"p99.9", 99.9}};
+        for (auto& [name, p] : marks)
+            os << "  " << name << " " << std::setw(8) << percentile(p) / 1000.0;
+        os << "  max " << std::setw(8) << max() / 1000.0 << " ms\n";
+    }
+
+    // Summary plus every non-empty bucket as [upper_us, count], for dashboards.
+    nlohmann::json toJson() const {
+        nlohmann::json buckets = nlohmann::json::array();
+        for (int i = 0; i < kBuckets; ++i)
+            if (counts[i]) buckets.push_back({highestEquivalent(i), counts[i]});
+        return {{"unit", "us"},
+                {"count", total},
+                {"min", min()},
+                {"mean", mean()},
+                {"p50", percentile(50)},
+                {"p90", percentile(90)},
+                {"p99", percentile(99)},
+                {"p99_9", percentile(99.9)},
+                {"max", max()},
+                {"buckets", buckets}};
+    }
+
+private:
+    std::array< uint64_t, kBuckets > counts{};
+    uint64_t                         total = 0, sum = 0;
+    uint64_t                         lo = UINT64_MAX, hi = 0;
+
+    static int indexOf(uint64_t v) {
+        if (v < uint64_t(kLinear)) return int(v);
+        int e = 63 - __builtin_clzll(v);  // e >= 7
+        int shift = e - 6;                // v >> shift lands in [64, 128)
+        return kLinear + (shift - 1) * kSub + int(v >> shift) - kSub;
+    }
+
+    static uint64_t highestEquivalent(int i) {
+        if (i < kLinear) return uint64_t(i);
+        int      k = i - kLinear;
+        int      shift = k / kSub + 1;
+        uint64_t m = uint64_t(k % kSub + kSub);
+        return ((m + 1) << shift) - 1;
+    }
+};
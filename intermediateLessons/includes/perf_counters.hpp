@@ -0,0 +1,140 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+// One reading of the hardware counters. A counter this machine doesn't have
+// reads as NaN, and so does anything computed from it.
+struct PerfSample {
+    double cycles = 0.0, instructions = 0.0;
+    double l1dMisses = 0.0, llcMisses = 0.0, branchMisses = 0.0;
+
+    PerfSample operator-(const PerfSample& o) const {
+        return {cycles - o.cycles, instructions - o.instructions, l1dMisses - o.l1dMisses,
+                llcMisses - o.llcMisses, branchMisses - o.branchMisses};
+    }
+    PerfSample& operator+=(const PerfSample& o) {
+        cycles += o.cycles;
+        instructions += o.instructions;
+        l1dMisses += o.l1dMisses;
+        llcMisses += o.llcMisses;
+        branchMisses += o.branchMisses;
+        return *this;
+    }
+
+    double ipc() const { return cycles > 0 ? instructions / cycles : NAN; }
+};
+
+// Hardware performance counters (cycles, instructions, L1d read misses, LLC
+// misses, branch misses) for this process, via perf_event_open on Linux.
+//
+//     PerfCounters perf;
+//     if (perf.open()) {
+//         PerfSample before = perf.read();
+//         work();
+//         PerfSample d = perf.read() - before;   // d.ipc(), d.l1dMisses, ...
+//     }
+//
+// The counters follow the calling thread and are inherited by threads it
+// creates *afterwards*, and read() includes them. So open() before starting a
+// thread pool if its work should count.
+//
+// Counters are often unavailable: other operating systems, containers without
+// CAP_PERFMON, a high kernel.perf_event_paranoid, VMs without a virtual PMU.
+// Then open() returns false, reason() says why and read() returns zeros, so
+// callers can keep calling it unconditionally.
+class PerfCounters {
+public:
+    static constexpr int         kCounters = 5;
+    static constexpr const char* kNames[kCounters] = {"cycles", "instructions", "L1d misses", "LLC misses",
+                                                      "branch misses"};
+
+    PerfCounters() = default;
+    ~PerfCounters() { close(); }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool open() {
+        close();
+        why.clear();
+#ifdef __linux__
+        const std::pair< uint32_t, uint64_t > events[kCounters] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},  // last-level cache
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+        for (int i = 0; i < kCounters; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;  // allowed at perf_event_paranoid <= 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[i] = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds[i] < 0)
+                why += std::string(why.empty() ? "" : ", ") + kNames[i] + ": " + std::strerror(errno);
+        }
+        // Without cycles and instructions there is not much worth reporting.
+        if (fds[0] < 0 || fds[1] < 0) {
+            close();
+            return false;
+        }
+        return true;
+#else
+        why = "hardware counters are only read on Linux";
+        return false;
+#endif
+    }
+
+    bool               available() const { return fds[0] >= 0; }
+    const std::string& reason() const { return why; }  // why open() failed, or which counters are missing
+
+    PerfSample read() const {
+        PerfSample s;
+        if (!available()) return s;
+        double* out[kCounters] = {&s.cycles, &s.instructions, &s.l1dMisses, &s.llcMisses, &s.branchMisses};
+        for (int i = 0; i < kCounters; ++i) *out[i] = value(fds[i]);
+        return s;
+    }
+
+private:
+    int         fds[kCounters] = {-1, -1, -1, -1, -1};
+    std::string why;
+
+    // Counter value, scaled up if the kernel had to multiplex it with others.
+    static double value(int fd) {
+#ifdef __linux__
+        if (fd < 0) return NAN;
+        uint64_t v[3];  // value, time enabled, time running
+        if (::read(fd, v, sizeof(v)) != ssize_t(sizeof(v))) return NAN;
+        return v[2] ? double(v[0]) * double(v[1]) / double(v[2]) : 0.0;
+#else
+        (void)fd;
+        return NAN;
+#endif
+    }
+
+    void close() {
+        for (int& fd : fds) {
+#ifdef __linux__
+            if (fd >= 0) ::close(fd);
+#endif
+            fd = -1;
+        }
+    }
+};
@@ -0,0 +1,171 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trace_events.hpp"
+
+// Fixed set of worker threads for data-parallel loops.
+//
+//     ThreadPool pool(4);                       // the caller counts as one of the 4
+//     pool.parallelFor(tiles, [&](int t) { stepTile(t); });
+//
+// parallelFor() hands out indices one at a time from a shared atomic counter, so
+// fast threads simply take more of them, and returns once every index has run.
+// The calling thread works too instead of just waiting. Not reentrant: don't call
+// parallelFor from inside a task.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads = int(std::thread::hardware_concurrency())) {
+        threads = std::max(1, threads);
+        for (int i = 1; i < threads; ++i) workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard< std::mutex > guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return int(workers.size()) + 1; }
+
+    void parallelFor(int count, const std::function< void(int) >& fn) {
+        if (count <= 0) return;
+        if (workers.empty() || count == 1) {
+            for (int i = 0; i < count; ++i) runTask(fn, i);
+            return;
+        }
+        {
+            std::lock_guard< std::mutex > guard(lock);
+            job = &fn;
+            jobCount = count;
+            next.store(0);
+            remaining.store(count);
+            ++jobId;
+        }
+        wake.notify_all();
+        drain(fn, count);
+
+        std::unique_lock< std::mutex > guard(lock);
+        finished.wait(guard, [&] { return remaining.load() == 0 && busy == 0; });
+        job = nullptr;
+    }
+
+    // Like parallelFor, for large numbers of small tasks of uneven cost. The index
+    // range starts out split into one contiguous slice per thread; each thread
+    // works through its own slice front to back, and when it runs dry steals the
+    // back half of the fullest remaining slice. fn gets (index, slot): a slot is
+    // never run by two threads at once, so it can index per-thread state such
+    // as scratch boards or tallies. Same reentrancy rule as parallelFor.
+    void parallelForStealing(long count, const std::function< void(long, int) >& fn) {
+        struct Slice {
+            std::mutex          lock;
+            std::atomic< long > begin{0}, end{0};  // written under lock, peeked at without
+        };
+        int                  slots = size();
+        std::vector< Slice > slices(slots);
+        for (int s = 0; s < slots; ++s) {
+            slices[s].begin = count * s / slots;
+            slices[s].end = count * (s + 1) / slots;
+        }
+        parallelFor(slots, [&](int slot) {
+            Slice& own = slices[slot];
+            while (true) {
+                long i = -1;
+                {
+                    std::lock_guard< std::mutex > guard(own.lock);
+                    if (own.begin < own.end) i = own.begin++;
+                }
+                if (i >= 0) {
+                    fn(i, slot);
+                    continue;
+                }
+                // Pick the fullest slice by an unlocked peek, then recheck under its lock.
+                int  victim = -1;
+                long most = 0;
+                for (int v = 0; v < slots; ++v) {
+                    long left = slices[v].end - slices[v].begin;
+                    if (v != slot && left > most) {
+                        most = left;
+                        victim = v;
+                    }
+                }
+                if (victim < 0) return;
+                long from, to;
+                {
+                    std::lock_guard< std::mutex > guard(slices[victim].lock);
+                    long left = slices[victim].end - slices[victim].begin;
+                    if (left <= 0) continue;
+                    to = slices[victim].end;
+                    from = to - (left + 1) / 2;
+                    slices[victim].end = from;
+                }
+                std::lock_guard< std::mutex > guard(own.lock);
+                own.begin = from;
+                own.end = to;
+            }
+        });
+    }
+
+private:
+    std::vector< std::thread >        workers;
+    std::mutex                        lock;
+    std::condition_variable           wake, finished;
+    const std::function< void(int) >* job = nullptr;
+    int                               jobCount = 0;
+    long                              jobId = 0;
+    int                               busy = 0;  // workers inside drain()
+    bool                              stopping = false;
+    std::atomic< int >                next{0}, remaining{0};
+
+    static void runTask(const std::function< void(int) >& fn, int i) {
+        TRACE_SCOPE("pool.task", "pool");
+        fn(i);
+    }
+
+    void drain(const std::function< void(int) >& fn, int count) {
+        for (int i; (i = next.fetch_add(1)) < count;) {
+            runTask(fn, i);
+            if (remaining.fetch_sub(1) == 1) {
+                std::lock_guard< std::mutex > guard(lock);
+                finished.notify_all();
+            }
+        }
+    }
+
+    void workerLoop(int id) {
+        Trace::setThreadName("pool worker " + std::to_string(id));
+        long seen = 0;
+        while (true) {
+            const std::function< void(int) >* fn;
+            int                               count;
+            {
+                std::unique_lock< std::mutex > guard(lock);
+                wake.wait(guard, [&] { return stopping || jobId != seen; });
+                if (stopping) return;
+                seen = jobId;
+                if (!job) continue;  // woke up after that job already finished
+                fn = job;
+                count = jobCount;
+                ++busy;
+            }
+            drain(*fn, count);
+            {
+                std::lock_guard< std::mutex > guard(lock);
+                --busy;
+            }
+            finished.notify_all();
+        }
+    }
+};
@@ -0,0 +1,180 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.hpp"
+
+// Timeline tracer that writes Chrome trace_event JSON (chrome://tracing, Perfetto).
+//
+//     Trace::start();
+//     { TRACE_SCOPE("grid.update", "sim"); grid.update(); }
+//     Trace::writeJson("trace.json");
+//
+// Each thread records into its own buffer, so recording never takes a lock or
+// touches memory another thread is writing. The only lock is taken once per
+// thread, the first time it records, to register its buffer. writeJson() reads
+// every buffer and must be called while no thread is recording (e.g. after the
+// game loop and the worker threads have stopped).
+namespace Trace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Event {
+        const char* name;  // must be a string literal (we keep the pointer)
+        const char* cat;
+        int64_t     startNs;
+        int64_t     durNs;
+    };
+
+    // Events are stored in fixed-size chunks so a busy thread allocates once per
+    // kChunk events instead of reallocating (and copying) one big vector.
+    struct ThreadBuffer {
+        static constexpr size_t kChunk = 4096;
+
+        std::vector< std::unique_ptr< std::array< Event, kChunk > > > chunks;
+        size_t                                                        used = kChunk;  // in the last chunk
+        uint32_t                                                      tid = 0;
+        std::string                                                   name;
+
+        void push(const Event& ev) {
+            if (used == kChunk) {
+                chunks.emplace_back(new std::array< Event, kChunk >);
+                used = 0;
+            }
+            (*chunks.back())[used++] = ev;
+        }
+
+        size_t size() const { return chunks.empty() ? 0 : (chunks.size() - 1) * kChunk + used; }
+    };
+
+    struct Registry {
+        std::mutex                                     lock;
+        std::vector< std::unique_ptr< ThreadBuffer > > buffers;
+        std::atomic< bool >                            enabled{false};
+        Clock::time_point                              epoch = Clock::now();
+    };
+
+    inline Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    // The calling thread's buffer, or nullptr before it has recorded anything.
+    inline ThreadBuffer*& localSlot() {
+        thread_local ThreadBuffer* buf = nullptr;
+        return buf;
+    }
+
+    // A name given before the thread's first event; its buffer is only
+    // registered once there is something to put in it.
+    inline std::string& pendingName() {
+        thread_local std::string name;
+        return name;
+    }
+
+    inline ThreadBuffer& localBuffer() {
+        ThreadBuffer*& buf = localSlot();
+        if (!buf) {
+            Registry&                     r = registry();
+            std::lock_guard< std::mutex > guard(r.lock);
+            r.buffers.emplace_back(new ThreadBuffer);
+            buf = r.buffers.back().get();
+            buf->tid = uint32_t(r.buffers.size());
+            buf->name = pendingName().empty() ? "thread " + std::to_string(buf->tid) : pendingName();
+        }
+        return *buf;
+    }
+
+    inline bool enabled() { return registry().enabled.load(std::memory_order_relaxed); }
+
+    inline void start() {
+        registry().epoch = Clock::now();
+        registry().enabled.store(true);
+    }
+
+    inline void stop() { registry().enabled.store(false); }
+
+    inline int64_t nowNs() {
+        return std::chrono::duration_cast< std::chrono::nanoseconds >(Clock::now() - registry().epoch).count();
+    }
+
+    // Names the calling thread in the timeline ("main", "pool worker 3", ...).
+    // Costs nothing while tracing is off: the name waits until the thread's
+    // first event registers its buffer.
+    inline void setThreadName(const std::string& name) {
+        if (ThreadBuffer* buf = localSlot())
+            buf->name = name;
+        else
+            pendingName() = name;
+    }
+
+    inline void record(const char* name, const char* cat, int64_t startNs, int64_t endNs) {
+        localBuffer().push({name, cat, startNs, endNs - startNs});
+    }
+
+    // Records a complete ("X") event covering the lifetime of the scope.
+    class Scope {
+    public:
+        Scope(const char* name, const char* cat) : name(name), cat(cat), startNs(enabled() ? nowNs() : -1) {}
+        ~Scope() {
+            if (startNs >= 0) record(name, cat, startNs, nowNs());
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        const char* cat;
+        int64_t     startNs;
+    };
+
+    inline size_t eventCount() {
+        size_t n = 0;
+        for (auto& b : registry().buffers) n += b->size();
+        return n;
+    }
+
+    // Dumps everything recorded so far in the Chrome trace_event JSON format.
+    inline bool writeJson(const std::string& path) {
+        using nlohmann::json;
+        Registry&                     r = registry();
+        std::lock_guard< std::mutex > guard(r.lock);
+
+        json events = json::array();
+        for (auto& buf : r.buffers) {
+            events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", buf->tid},
+                              {"args", {{"name", buf->name}}}});
+            for (size_t c = 0; c < buf->chunks.size(); ++c) {
+                size_t n = c + 1 == buf->chunks.size() ? buf->used : ThreadBuffer::kChunk;
+                for (size_t i = 0; i < n; ++i) {
+                    const Event& ev = (*buf->chunks[c])[i];
+                    events.push_back({{"name", ev.name},
+                                      {"cat", ev.cat},
+                                      {"ph", "X"},
+                                      {"ts", double(ev.startNs) / 1000.0},  // microseconds
+                                      {"dur", double(ev.durNs) / 1000.0},
+                                      {"pid", 1},
+                                      {"tid", buf->tid}});
+                }
+            }
+        }
+
+        std::ofstream out(path);
+        if (!out) return false;
+        out << json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump();
+        return bool(out);
+    }
+
+}  // namespace Trace
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name, cat) Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name, cat)
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "../includes/frame_limiter.hpp"
 #include "../includes/json.hpp"
 using nlohmann::json;
 
@@ -37,8 +38,9 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    bool      running = true;
-    SDL_Event event;
+    bool         running = true;
+    SDL_Event    event;
+    FrameLimiter limiter;
 
     while (running) {
         while (SDL_PollEvent(&event)) {
@@ -56,8 +58,9 @@ int main(int argc, char* argv[]) {
             SDL_RenderDrawLine(renderer, 0, y, 800, y);
 
         SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        limiter.wait();
     }
+    limiter.report(cout);
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
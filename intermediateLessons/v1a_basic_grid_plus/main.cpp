@@ -4,6 +4,7 @@
 #include <stdexcept>
 
 #include "../includes/argsToJson.hpp"
+#include "../includes/frame_limiter.hpp"
 #include "../includes/json.hpp"
 using nlohmann::json;
 
@@ -45,8 +46,9 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    bool      running = true;
-    SDL_Event event;
+    bool         running = true;
+    SDL_Event    event;
+    FrameLimiter limiter;
 
     while (running) {
         while (SDL_PollEvent(&event)) {
@@ -66,8 +68,9 @@ int main(int argc, char* argv[]) {
             SDL_RenderDrawLine(renderer, 0, y, width, y);
 
         SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        limiter.wait();
     }
+    limiter.report(cout);
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -4,6 +4,8 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "../includes/frame_limiter.hpp"
+
 struct RenderContext {
     SDL_Window*   window = nullptr;
     SDL_Renderer* renderer = nullptr;
@@ -45,16 +47,18 @@ class GameEngine {
 public:
     GameEngine(RenderContext ctx, int cellSize) : ctx(ctx), cellSize(cellSize) {}
     void run() {
-        SDL_Event e;
-        bool      running = true;
+        SDL_Event    e;
+        bool         running = true;
+        FrameLimiter limiter;
         while (running) {
             while (SDL_PollEvent(&e)) {
                 if (e.type == SDL_QUIT)
                     running = false;
             }
             draw_grid();
-            SDL_Delay(16);
+            limiter.wait();
         }
+        limiter.report(std::cout);
     }
 
 private:
@@ -3,6 +3,7 @@
 
 #include <iostream>
 
+#include "../includes/frame_limiter.hpp"
 #include "grid.hpp"
 
 struct RenderContext {
@@ -62,13 +63,15 @@ public:
     }
 
     void run() {
-        SDL_Event e;
+        SDL_Event    e;
+        FrameLimiter limiter;
         while (running) {
             while (SDL_PollEvent(&e)) handle_event(e);
             grid.draw(ctx.renderer);
             SDL_RenderPresent(ctx.renderer);
-            SDL_Delay(16);
+            limiter.wait();
         }
+        limiter.report(std::cout);
         SDL_DestroyRenderer(ctx.renderer);
         SDL_DestroyWindow(ctx.window);
     }
@@ -0,0 +1,192 @@
+#pragma once
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
+
+#include "../includes/json.hpp"
+#include "./engines.hpp"
+
+using nlohmann::json;
+
+// The update engine, thread count and tile size to use on this machine.
+struct TunedConfig {
+    std::string  engine = "reference";
+    EngineConfig cfg;
+    double       cellsPerSec = 0.0;  // measured during calibration (0 = not measured)
+};
+
+inline std::string cpuModel() {
+#if defined(__APPLE__)
+    char   buf[256];
+    size_t len = sizeof(buf);
+    if (sysctlbyname("machdep.cpu.brand_string", buf, &len, nullptr, 0) == 0) return std::string(buf);
+#elif defined(__linux__)
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string   line;
+    while (std::getline(cpuinfo, line))
+        if (line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0) {
+            auto colon = line.find(':');
+            if (colon != std::string::npos) return line.substr(line.find_first_not_of(" \t", colon + 1));
+        }
+#endif
+    return "unknown cpu";
+}
+
+inline int coreCount() { return std::max(1, int(std::thread::hardware_concurrency())); }
+
+// Profile entries are keyed by CPU model and core count, so one profile file in a
+// shared home directory can serve a mixed fleet.
+inline std::string machineKey() { return cpuModel() + " / " + std::to_string(coreCount()) + " cores"; }
+
+// Picks the fastest engine configuration for this machine and remembers it.
+//
+// Calibration steps a random soup on a size x size board with every candidate:
+// each registered engine, and for engines that use them, thread counts
+// 1, 2, 4, ... up to the core count, a few tile sizes and blocking depths. The
+// winner goes into a JSON profile under machineKey().
+class AutoTuner {
+public:
+    explicit AutoTuner(std::string path) : path(std::move(path)) {}
+
+    static std::string defaultPath() {
+        const char* home = std::getenv("HOME");
+        return home ? std::string(home) + "/.gol_profile.json" : "gol_profile.json";
+    }
+
+    bool load(TunedConfig& out) const {
+        json doc = readProfile();
+        if (!doc.contains(machineKey())) return false;
+        const json& e = doc[machineKey()];
+        out.engine = e.value("engine", out.engine);
+        out.cfg.threads = e.value("threads", out.cfg.threads);
+        out.cfg.tile = e.value("tile", out.cfg.tile);
+        out.cfg.depth = e.value("depth", out.cfg.depth);
+        out.cellsPerSec = e.value("cells_per_sec", 0.0);
+        return makeEngine(out.engine, 1, 1) != nullptr;  // ignore engines this build doesn't have
+    }
+
+    void save(const TunedConfig& t) const {
+        json doc = readProfile();
+        doc[machineKey()] = {{"engine", t.engine},
+                             {"threads", t.cfg.threads},
+                             {"tile", t.cfg.tile},
+                             {"depth", t.cfg.depth},
+                             {"cells_per_sec", t.cellsPerSec}};
+        std::ofstream out(path);
+        out << doc.dump(2) << "\n";
+        if (!out) std::cerr << "Could not write tuning profile " << path << "\n";
+    }
+
+    TunedConfig calibrate(int size = 1024, double secondsEach = 0.1, std::ostream& log = std::cout) const {
+        log << "Calibrating update engines for " << machineKey() << " on a " << size << "x" << size << " board...\n";
+        TunedConfig best;
+        for (auto& info : engineRegistry()) {
+            std::vector< int > threadCounts = {1}, tiles = {EngineConfig().tile}, depths = {EngineConfig().depth};
+            if (info.knobs & EngineInfo::kThreads)
+                for (int t = 2; t <= coreCount(); t *= 2) threadCounts.push_back(t);
+            if (info.knobs & EngineInfo::kThreads && (coreCount() & (coreCount() - 1)))
+                threadCounts.push_back(coreCount());  // not a power of two
+            if (info.knobs & EngineInfo::kTile) tiles = {32, 64, 128, 256};
+            if (info.knobs & EngineInfo::kDepth) depths = {2, 4, 8};
+
+            for (int t : threadCounts)
+                for (int tile : tiles)
+                    for (int depth : depths) {
+                        EngineConfig cfg;
+                        cfg.threads = t;
+                        cfg.tile = tile;
+                        cfg.depth = depth;
+                        double rate = measure(info, size, cfg, secondsEach);
+                        log << "  " << std::left << std::setw(12) << info.name << std::right << " threads "
+                            << std::setw(3) << t << "  tile " << std::setw(4) << tile << "  depth " << depth
+                            << "  " << std::fixed << std::setprecision(1) << rate / 1e6 << " Mcells/s\n";
+                        if (rate > best.cellsPerSec) best = {info.name, cfg, rate};
+                    }
+        }
+        log << "Best: " << best.engine << " threads=" << best.cfg.threads << " tile=" << best.cfg.tile
+            << " depth=" << best.cfg.depth << "\n";
+        return best;
+    }
+
+private:
+    static constexpr int kBatch = 8;  // generations per stepMany(), lets temporal blocking do its thing
+
+    std::string path;
+
+    json readProfile() const {
+        std::ifstream in(path);
+        if (!in) return json::object();
+        json doc = json::parse(in, nullptr, false);
+        return doc.is_object() ? doc : json::object();
+    }
+
+    static double measure(const EngineInfo& info, int size, const EngineConfig& cfg, double seconds) {
+        using Clock = std::chrono::steady_clock;
+        auto eng = info.make(size, size, cfg);
+        seedRandom(*eng, 0.3, 1);
+        eng->stepMany(kBatch);  // warm-up: first touch of the buffers, thread start-up
+
+        long   gens = 0;
+        double secs = 0.0;
+        auto   t0 = Clock::now();
+        while (gens < 3 * kBatch || secs < seconds) {
+            eng->stepMany(kBatch);
+            gens += kBatch;
+            secs = std::chrono::duration< double >(Clock::now() - t0).count();
+        }
+        return double(size) * size * gens / secs;
+    }
+};
+
+// Works out which engine to run with, in priority order:
+//   1. explicit engine= / threads= / tile= / depth= arguments (always win)
+//   2. this machine's entry in the tuning profile (profile=<path>)
+//   3. a fresh calibration, saved to the profile for next time
+// Naming the engine skips calibration: knobs it uses that weren't given come
+// from the profile entry if there is one, otherwise from EngineConfig's defaults.
+// autotune=false skips 2 and 3 and uses the reference engine defaults.
+// unbounded=true needs an engine without edges, so it means the sparse engine
+// unless another one that supports it is named.
+inline TunedConfig resolveEngine(const json& params) {
+    TunedConfig t;
+    bool        named = params.contains("engine");
+    bool        unbounded = params.value("unbounded", false);
+    if (unbounded && !named) t.engine = "sparse";
+    if (params.value("autotune", true) && !unbounded) {
+        AutoTuner   tuner(params.value("profile", AutoTuner::defaultPath()));
+        TunedConfig profiled;
+        if (tuner.load(profiled)) {
+            if (named) {
+                unsigned knobs = 0;
+                for (auto& info : engineRegistry())
+                    if (info.name == params.value("engine", "")) knobs = info.knobs;
+                if (knobs & EngineInfo::kThreads) t.cfg.threads = profiled.cfg.threads;
+                if (knobs & EngineInfo::kTile) t.cfg.tile = profiled.cfg.tile;
+                if (knobs & EngineInfo::kDepth) t.cfg.depth = profiled.cfg.depth;
+            } else
+                t = profiled;
+        } else if (!named) {
+            t = tuner.calibrate(params.value("tune_size", 1024));
+            tuner.save(t);
+        }
+    }
+    t.engine = params.value("engine", t.engine);
+    t.cfg.threads = params.value("threads", t.cfg.threads);
+    t.cfg.tile = params.value("tile", t.cfg.tile);
+    t.cfg.depth = params.value("depth", t.cfg.depth);
+    t.cfg.boundary = parseBoundary(params.value("boundary", "dead"));
+    t.cfg.unbounded = unbounded;
+    for (auto& info : engineRegistry())
+        if (unbounded && info.name == t.engine && !(info.knobs & EngineInfo::kUnbounded))
+            std::cerr << "Engine " << t.engine << " has edges; unbounded=true is ignored\n";
+    return t;
+}
@@ -0,0 +1,151 @@
+// =============================================================
+// bench_grid.cpp - Simulation benchmark for every Grid update engine
+// =============================================================
+// Compile (macOS example):
+// g++ -std=c++17 -O3 bench_grid.cpp -o bench_grid -I/opt/homebrew/include/SDL2 -L/opt/homebrew/lib -lSDL2
+//
+// Run (all arguments optional):
+// ./bench_grid sizes=256,1024,4096 densities=10,30,50 patterns=true min_time=0.5 out=bench.json
+//
+//   sizes      board edge lengths (square boards), default 256 .. 16384
+//   densities  random soup densities in percent, default 10,30,50
+//   patterns   also run every entry of patterns.json centred on the board
+//   engines    one engine name, default all registered engines
+//   min_time   seconds to keep stepping each case (at least one generation)
+//   max_gens   upper bound on generations per case
+//   threads, tile, depth   passed to engines that use them
+//   batch      generations per stepMany() call (default 8)
+//   boundary   dead (default) or wrap
+//   label      free-form tag (e.g. a commit hash) stored in the output
+//   sparse_max_live   skip soups that would start with more live cells than this on
+//              engines whose memory follows the population (default 4000000)
+//
+// Results go to `out` as JSON, one record per (engine, size, seed), each with a
+// stable "key" so runs from different commits can be joined and diffed.
+// =============================================================
+
+#include "engines.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../includes/argsToJson.hpp"
+
+using namespace std;
+
+static vector< int > intList(const json& params, const string& key, vector< int > fallback) {
+    if (!params.contains(key)) return fallback;
+    if (params[key].is_array()) return params[key].get< vector< int > >();
+    return {params[key].get< int >()};
+}
+
+struct Seed {
+    string         kind;  // "random" or "pattern"
+    string         name;
+    double         density = 0.0;
+    const Pattern* pattern = nullptr;
+};
+
+int main(int argc, char* argv[]) {
+    json params = ArgsToJson(argc, argv);
+
+    vector< int > sizes = intList(params, "sizes", {256, 512, 1024, 2048, 4096, 8192, 16384});
+    vector< int > densities = intList(params, "densities", {10, 30, 50});
+    double        minTime = params.value("min_time", 0.5);
+    long          maxGens = params.value("max_gens", 1000L);
+    string        only = params.value("engines", "all");
+    string        outPath = params.value("out", "bench_results.json");
+    uint64_t      seed = params.value("seed", 42ULL);
+    int           batch = max(1, params.value("batch", 8));
+    double        sparseMaxLive = params.value("sparse_max_live", 4e6);
+
+    EngineConfig cfg;
+    cfg.threads = params.value("threads", cfg.threads);
+    cfg.tile = params.value("tile", cfg.tile);
+    cfg.depth = params.value("depth", cfg.depth);
+    cfg.boundary = parseBoundary(params.value("boundary", "dead"));
+
+    vector< Pattern > patterns;
+    if (params.value("patterns", true))
+        patterns = loadPatterns(params.value("patterns_file", "../../patterns.json"));
+
+    vector< Seed > seeds;
+    for (int d : densities) seeds.push_back({"random", "soup_" + to_string(d), d / 100.0, nullptr});
+    for (auto& p : patterns) seeds.push_back({"pattern", p.name, 0.0, &p});
+
+    json results = json::array();
+    cout << left << setw(12) << "engine" << setw(8) << "size" << setw(24) << "seed" << right
+         << setw(8) << "gens" << setw(14) << "Mcells/s" << setw(10) << "ns/cell" << setw(12) << "KiB" << "\n";
+
+    using Clock = chrono::steady_clock;
+    for (int size : sizes)
+        for (auto& info : engineRegistry()) {
+            if (only != "all" && only != info.name) continue;
+            for (auto& s : seeds) {
+                if (info.knobs & EngineInfo::kSparse && double(size) * size * s.density > sparseMaxLive) {
+                    cout << left << setw(12) << info.name << setw(8) << size << setw(24) << s.name
+                         << "skipped (sparse engine, too many live cells)\n";
+                    continue;
+                }
+                auto eng = info.make(size, size, cfg);
+                if (s.pattern)
+                    seedPattern(*eng, *s.pattern);
+                else
+                    seedRandom(*eng, s.density, seed);
+
+                long   gens = 0;
+                double secs = 0.0;
+                auto   t0 = Clock::now();
+                while (gens < maxGens && (gens == 0 || secs < minTime)) {
+                    int n = int(min< long >(batch, maxGens - gens));
+                    eng->stepMany(n);
+                    gens += n;
+                    secs = chrono::duration< double >(Clock::now() - t0).count();
+                }
+
+                double cells = double(size) * size * gens;
+                double rate = cells / secs;
+                json   r = {{"key", info.name + "/" + to_string(size) + "/" + s.name},
+                            {"engine", info.name},
+                            {"size", size},
+                            {"seed_kind", s.kind},
+                            {"seed", s.name},
+                            {"density", s.density},
+                            {"threads", cfg.threads},
+                            {"tile", cfg.tile},
+                            {"depth", cfg.depth},
+                            {"batch", batch},
+                            {"boundary", boundaryName(cfg.boundary)},
+                            {"generations", gens},
+                            {"seconds", secs},
+                            {"cell_updates_per_sec", rate},
+                            {"ns_per_cell", 1e9 / rate},
+                            {"bytes", eng->bytes()},
+                            {"final_population", eng->population()}};
+                results.push_back(r);
+
+                cout << left << setw(12) << info.name << setw(8) << size << setw(24) << s.name << right
+                     << setw(8) << gens << fixed << setprecision(1) << setw(14) << rate / 1e6
+                     << setprecision(3) << setw(10) << 1e9 / rate << setprecision(1) << setw(12)
+                     << eng->bytes() / 1024.0 << "\n";
+            }
+        }
+
+    json doc = {{"label", params.value("label", "")},
+                {"cpus", thread::hardware_concurrency()},
+                {"min_time", minTime},
+                {"results", results}};
+    ofstream out(outPath);
+    out << doc.dump(2) << "\n";
+    if (!out) {
+        cerr << "Could not write " << outPath << "\n";
+        return 1;
+    }
+    cout << "Wrote " << results.size() << " results to " << outPath << "\n";
+    return 0;
+}
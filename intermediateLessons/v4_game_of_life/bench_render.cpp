@@ -0,0 +1,189 @@
+// =============================================================
+// bench_render.cpp - Draw-path benchmark on an offscreen software renderer
+// =============================================================
+// Compile (macOS example):
+// g++ -std=c++17 -O3 bench_render.cpp -o bench_render -I/opt/homebrew/include/SDL2 -L/opt/homebrew/lib -lSDL2 -lSDL2_ttf
+//
+// Run (all arguments optional):
+// ./bench_render width=800 height=600 cell_sizes=4,8,16,32 live=0,1,10,50 min_time=0.25 out=render.json
+//
+//   cell_sizes   cell edge lengths in pixels
+//   live         live cells as a percentage of the board
+//   text_lines   lines of overlay text per frame (needs SDL_ttf and a font)
+//   font         font file for the text overlay
+//
+// Everything renders into an SDL_Surface through SDL_CreateSoftwareRenderer, so no
+// window, display or GPU is needed. For each case it times three paths:
+//
+//   grid    Grid::draw()      (clear + live cells + grid lines)
+//   lines   Grid::drawLines() (grid lines only)
+//   text    a HUD-style text overlay rendered with SDL_ttf every frame
+//
+// and reports draw calls and microseconds per frame, plus the bytes a GPU backend
+// would have to upload: texture bytes for text, and 16 bytes per rect or line of
+// geometry (SDL2 sends rects and lines as float pairs).
+// =============================================================
+
+#include "grid.hpp"
+
+#include <SDL_ttf.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../includes/argsToJson.hpp"
+
+using namespace std;
+
+static vector< int > intList(const json& params, const string& key, vector< int > fallback) {
+    if (!params.contains(key)) return fallback;
+    if (params[key].is_array()) return params[key].get< vector< int > >();
+    return {params[key].get< int >()};
+}
+
+struct FrameCost {
+    long   drawCalls = 0;
+    long   geometryBytes = 0;
+    long   textureBytes = 0;
+    double usPerFrame = 0.0;
+    long   frames = 0;
+};
+
+// Runs `frame` until `minTime` seconds have passed; `frame` fills in the per-frame
+// draw call and byte counts (they are the same every frame).
+template < typename F >
+static FrameCost timeFrames(SDL_Renderer* renderer, double minTime, F frame) {
+    using Clock = chrono::steady_clock;
+    FrameCost cost;
+    auto      t0 = Clock::now();
+    double    secs = 0.0;
+    while (cost.frames == 0 || secs < minTime) {
+        cost.drawCalls = cost.geometryBytes = cost.textureBytes = 0;
+        frame(cost);
+        SDL_RenderPresent(renderer);  // flushes the queued commands into the surface
+        ++cost.frames;
+        secs = chrono::duration< double >(Clock::now() - t0).count();
+    }
+    cost.usPerFrame = secs * 1e6 / cost.frames;
+    return cost;
+}
+
+static TTF_Font* openFont(const string& preferred) {
+    const char* candidates[] = {
+        preferred.c_str(),
+        "/System/Library/Fonts/Menlo.ttc",
+        "/System/Library/Fonts/Supplemental/Arial.ttf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+        "DejaVuSans.ttf"};
+    for (const char* path : candidates)
+        if (*path)
+            if (TTF_Font* f = TTF_OpenFont(path, 14)) return f;
+    return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    json params = ArgsToJson(argc, argv);
+
+    int           width = params.value("width", 800);
+    int           height = params.value("height", 600);
+    vector< int > cellSizes = intList(params, "cell_sizes", {4, 8, 16, 32});
+    vector< int > livePcts = intList(params, "live", {0, 1, 10, 50});
+    int           textLines = params.value("text_lines", 5);
+    double        minTime = params.value("min_time", 0.25);
+    string        outPath = params.value("out", "bench_render.json");
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!target) {
+        cerr << "Surface Error: " << SDL_GetError() << endl;
+        return 1;
+    }
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+    if (!renderer) {
+        cerr << "Renderer Error: " << SDL_GetError() << endl;
+        SDL_FreeSurface(target);
+        return 1;
+    }
+
+    TTF_Font* font = nullptr;
+    if (TTF_Init() == 0) font = openFont(params.value("font", ""));
+    if (!font) cout << "No font available, skipping the text overlay path\n";
+
+    json results = json::array();
+    cout << left << setw(8) << "path" << setw(8) << "cell" << setw(8) << "live%" << right << setw(10)
+         << "cells" << setw(10) << "calls" << setw(12) << "us/frame" << setw(12) << "KiB up" << "\n";
+
+    auto report = [&](const string& path, int cell, int pct, long live, const FrameCost& c) {
+        long bytes = c.geometryBytes + c.textureBytes;
+        results.push_back({{"path", path},
+                           {"cell_size", cell},
+                           {"live_percent", pct},
+                           {"live_cells", live},
+                           {"draw_calls", c.drawCalls},
+                           {"us_per_frame", c.usPerFrame},
+                           {"geometry_bytes", c.geometryBytes},
+                           {"texture_bytes", c.textureBytes},
+                           {"bytes_uploaded", bytes},
+                           {"frames", c.frames}});
+        cout << left << setw(8) << path << setw(8) << cell << setw(8) << pct << right << setw(10) << live
+             << setw(10) << c.drawCalls << fixed << setprecision(1) << setw(12) << c.usPerFrame
+             << setw(12) << bytes / 1024.0 << "\n";
+    };
+
+    for (int cell : cellSizes) {
+        Grid grid(width, height, cell);
+        for (int pct : livePcts) {
+            grid.randomize(pct / 100.0, 42);
+            long live = grid.population();
+
+            FrameCost g = timeFrames(renderer, minTime, [&](FrameCost& c) {
+                c.drawCalls = grid.draw(renderer);
+                c.geometryBytes = 16 * (c.drawCalls - 1);  // everything but the clear
+            });
+            report("grid", cell, pct, live, g);
+        }
+
+        FrameCost l = timeFrames(renderer, minTime, [&](FrameCost& c) {
+            c.drawCalls = grid.drawLines(renderer);
+            c.geometryBytes = 16 * c.drawCalls;
+        });
+        report("lines", cell, 0, 0, l);
+    }
+
+    if (font) {
+        SDL_Color white = {235, 235, 235, 255};
+        FrameCost t = timeFrames(renderer, minTime, [&](FrameCost& c) {
+            for (int i = 0; i < textLines; ++i) {
+                string       text = "update   min 0.12  avg 0.20  p99 0.51  line " + to_string(i);
+                SDL_Surface* surf = TTF_RenderText_Blended(font, text.c_str(), white);
+                if (!surf) continue;
+                SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
+                SDL_Rect     dst = {8, 8 + i * surf->h, surf->w, surf->h};
+                SDL_RenderCopy(renderer, tex, NULL, &dst);
+                c.textureBytes += long(surf->pitch) * surf->h;
+                c.drawCalls += 1;
+                SDL_DestroyTexture(tex);
+                SDL_FreeSurface(surf);
+            }
+        });
+        report("text", 0, 0, 0, t);
+        TTF_CloseFont(font);
+    }
+    if (TTF_WasInit()) TTF_Quit();
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+
+    json doc = {{"width", width}, {"height", height}, {"renderer", "software"}, {"results", results}};
+    ofstream out(outPath);
+    out << doc.dump(2) << "\n";
+    if (!out) {
+        cerr << "Could not write " << outPath << "\n";
+        return 1;
+    }
+    cout << "Wrote " << results.size() << " results to " << outPath << "\n";
+    return 0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../includes/thread_pool.hpp"
+#include "./life_engine.hpp"
+
+// A board snapshot at one bit per cell, rows padded to whole 64-bit words, in
+// exportRow() layout: bit i of word w of a row = column 64 * w + i.
+struct BitBoard {
+    int                     rows = 0, cols = 0, words = 0;  // words per row
+    std::vector< uint64_t > bits;
+
+    void resize(int r, int c) {
+        rows = r;
+        cols = c;
+        words = (c + 63) / 64;
+        bits.assign(size_t(rows) * words, 0);
+    }
+
+    uint64_t*       row(int r) { return &bits[size_t(r) * words]; }
+    const uint64_t* row(int r) const { return &bits[size_t(r) * words]; }
+
+    bool get(int r, int c) const { return row(r)[c / 64] >> (c % 64) & 1; }
+
+    void set(int r, int c, bool alive) {
+        uint64_t bit = uint64_t(1) << (c % 64);
+        row(r)[c / 64] = alive ? row(r)[c / 64] | bit : row(r)[c / 64] & ~bit;
+    }
+
+    // The 64 cells of row r starting at column x: bit b = column x + b. x may be
+    // negative and the window may run past either edge; off-board cells are dead.
+    uint64_t window(int r, int x) const {
+        if (r < 0 || r >= rows) return 0;
+        const uint64_t* p = row(r);
+        int             w = x >> 6, s = x & 63;  // floor division, so negative x works too
+        uint64_t        lo = w >= 0 && w < words ? p[w] : 0;
+        if (s == 0) return lo;
+        uint64_t hi = w + 1 >= 0 && w + 1 < words ? p[w + 1] : 0;
+        return lo >> s | hi << (64 - s);
+    }
+
+    long population() const {
+        long n = 0;
+        for (uint64_t w : bits) n += __builtin_popcountll(w);
+        return n;
+    }
+
+    // Copies the engine's current state, a band of rows per task when given a pool.
+    void load(const LifeEngine& eng, ThreadPool* pool = nullptr, int bandRows = 64) {
+        if (eng.rows() != rows || eng.cols() != cols) resize(eng.rows(), eng.cols());
+        int bands = (rows + bandRows - 1) / bandRows;
+        auto exportBand = [&](int b) {
+            for (int r = b * bandRows; r < std::min(rows, (b + 1) * bandRows); ++r) eng.exportRow(r, row(r));
+        };
+        if (pool)
+            pool->parallelFor(bands, exportBand);
+        else
+            for (int b = 0; b < bands; ++b) exportBand(b);
+    }
+};
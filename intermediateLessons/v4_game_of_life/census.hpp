@@ -0,0 +1,315 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../includes/json.hpp"
+#include "../includes/thread_pool.hpp"
+#include "./cycle_detector.hpp"
+#include "./engine_sparse.hpp"
+#include "./fingerprint.hpp"
+
+using nlohmann::json;
+
+// Small, fast, and the same numbers on every platform (unlike std:: distributions).
+struct SplitMix64 {
+    uint64_t state;
+
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+};
+
+enum class ObjectKind { StillLife, Oscillator, Spaceship, Other };
+
+inline const char* kindName(ObjectKind k) {
+    switch (k) {
+        case ObjectKind::StillLife: return "still_life";
+        case ObjectKind::Oscillator: return "oscillator";
+        case ObjectKind::Spaceship: return "spaceship";
+        default: return "other";
+    }
+}
+
+struct CensusObject {
+    ObjectKind  kind = ObjectKind::Other;
+    int         period = 0;
+    uint64_t    fp = 0;  // same for every phase, position and orientation
+    std::string code;    // apgsearch-style name
+};
+
+// Splits live cells into objects: cells within `mergeDistance` of each other
+// (Chebyshev distance, so 1 = plain 8-connectivity) belong together. 2 also keeps
+// things that touch a dead cell from both sides, which still interact, together.
+inline std::vector< std::vector< Cell > > splitObjects(const std::vector< uint64_t >& keys, int mergeDistance) {
+    std::unordered_map< uint64_t, int > index;
+    index.reserve(keys.size() * 2);
+    for (int i = 0; i < int(keys.size()); ++i) index[keys[i]] = i;
+
+    std::vector< int > parent(keys.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](int i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    for (int i = 0; i < int(keys.size()); ++i) {
+        int r = SparseEngine::rowOf(keys[i]), c = SparseEngine::colOf(keys[i]);
+        for (int dr = -mergeDistance; dr <= mergeDistance; ++dr)
+            for (int dc = -mergeDistance; dc <= mergeDistance; ++dc) {
+                auto it = index.find(SparseEngine::key(r + dr, c + dc));
+                if (it != index.end()) parent[find(it->second)] = find(i);
+            }
+    }
+
+    std::unordered_map< int, int >     slot;
+    std::vector< std::vector< Cell > > objects;
+    for (int i = 0; i < int(keys.size()); ++i) {
+        auto [it, fresh] = slot.emplace(find(i), int(objects.size()));
+        if (fresh) objects.emplace_back();
+        objects[it->second].push_back({SparseEngine::rowOf(keys[i]), SparseEngine::colOf(keys[i])});
+    }
+    return objects;
+}
+
+// Classifies one object by how it repeats on its own (see findPeriod()); anything
+// that doesn't within maxPeriod generations, or dies, is Other. The code is
+// xs<population> for still lifes, xp<period> for oscillators, xq<period> for
+// spaceships, then the smallest canonical shape over every phase.
+inline CensusObject classifyObject(const std::vector< Cell >& cells, int maxPeriod) {
+    CensusObject obj;
+    Periodicity  per = findPeriod(cells, maxPeriod);
+    if (per.period == 0) {
+        obj.code = "xx_" + std::to_string(cells.size());  // unstable, dying, or period too long
+        obj.fp = std::hash< std::string >()(obj.code);
+        return obj;
+    }
+    obj.kind = per.moves ? ObjectKind::Spaceship : per.period == 1 ? ObjectKind::StillLife : ObjectKind::Oscillator;
+    obj.period = per.period;
+
+    Shape best = canonicalShape(per.phases[0]);
+    for (size_t i = 1; i < per.phases.size(); ++i)
+        if (Shape s = canonicalShape(per.phases[i]); s < best) best = std::move(s);
+    obj.fp = fingerprint(best);
+    obj.code = (obj.kind == ObjectKind::StillLife    ? "xs" + std::to_string(cells.size())
+                : obj.kind == ObjectKind::Oscillator ? "xp" + std::to_string(per.period)
+                                                     : "xq" + std::to_string(per.period)) +
+               "_" + shapeCode(best);
+    return obj;
+}
+
+struct CensusConfig {
+    int    soupSize = 16;       // soups are soupSize x soupSize on an unbounded plane
+    double density = 0.5;
+    long   maxGenerations = 10000;
+    int    checkEvery = 256;    // generations between "is everything classifiable yet?" checks
+    int    mergeDistance = 2;
+    int    maxPeriod = 64;
+};
+
+struct SoupResult {
+    long                        generations = 0;
+    bool                        settled = false;
+    std::vector< CensusObject > objects;
+};
+
+// 64-bit hash of a sorted live-cell list (boardHash() only sees the window).
+inline uint64_t hashKeys(const std::vector< uint64_t >& keys) {
+    uint64_t h = keys.size();
+    for (uint64_t k : keys) {
+        h ^= k + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h *= 0xff51afd7ed558ccdULL;
+    }
+    return h ^ (h >> 33);
+}
+
+// One soup from seed to census entries. It has settled when the whole board
+// cycles, or when every object in it classifies (spaceships flying off forever
+// never make the whole board repeat).
+inline SoupResult runSoup(uint64_t seed, const CensusConfig& cfg) {
+    EngineConfig engCfg;
+    engCfg.unbounded = true;
+    SparseEngine eng(cfg.soupSize, cfg.soupSize, engCfg);
+    SplitMix64   rng(seed);
+    uint64_t     threshold = uint64_t(cfg.density * 18446744073709551615.0);
+    for (int r = 0; r < cfg.soupSize; ++r)
+        for (int c = 0; c < cfg.soupSize; ++c)
+            if (rng.next() < threshold) eng.set(r, c, true);
+
+    auto classifyAll = [&] {
+        std::vector< CensusObject > out;
+        for (auto& cells : splitObjects(eng.liveKeys(), cfg.mergeDistance))
+            out.push_back(classifyObject(cells, cfg.maxPeriod));
+        return out;
+    };
+
+    SoupResult    result;
+    CycleDetector cycles(cfg.maxPeriod);
+    for (long g = 0; g <= cfg.maxGenerations; ++g) {
+        result.generations = g;
+        if (cycles.observe(g, hashKeys(eng.liveKeys()))) {
+            result.settled = true;
+            break;
+        }
+        if (g > 0 && g % cfg.checkEvery == 0) {
+            result.objects = classifyAll();
+            bool done = std::none_of(result.objects.begin(), result.objects.end(),
+                                     [](const CensusObject& o) { return o.kind == ObjectKind::Other; });
+            if (done) {
+                result.settled = true;
+                return result;
+            }
+        }
+        eng.step();
+    }
+    result.objects = classifyAll();
+    return result;
+}
+
+// Tally of one or more soups, keyed by fingerprint.
+struct Census {
+    struct Entry {
+        std::string code;
+        ObjectKind  kind;
+        int         period;
+        long        count = 0;
+    };
+
+    long                                  soups = 0, unsettled = 0, generations = 0;
+    long                                  byKind[4] = {};
+    std::unordered_map< uint64_t, Entry > objects;
+
+    void add(const SoupResult& r) {
+        ++soups;
+        generations += r.generations;
+        if (!r.settled) ++unsettled;
+        for (auto& o : r.objects) {
+            ++byKind[int(o.kind)];
+            objects.try_emplace(o.fp, Entry{o.code, o.kind, o.period}).first->second.count++;
+        }
+    }
+
+    void merge(const Census& other) {
+        soups += other.soups;
+        unsettled += other.unsettled;
+        generations += other.generations;
+        for (int k = 0; k < 4; ++k) byKind[k] += other.byKind[k];
+        for (auto& [fp, e] : other.objects)
+            objects.try_emplace(fp, Entry{e.code, e.kind, e.period}).first->second.count += e.count;
+    }
+
+    // (fingerprint, entry), most common first.
+    std::vector< std::pair< uint64_t, Entry > > sorted() const {
+        std::vector< std::pair< uint64_t, Entry > > out(objects.begin(), objects.end());
+        std::sort(out.begin(), out.end(), [](auto& a, auto& b) {
+            return a.second.count != b.second.count ? a.second.count > b.second.count : a.second.code < b.second.code;
+        });
+        return out;
+    }
+};
+
+// Batch mode: runs many random soups across every core and writes what came out
+// of them as a census.
+//
+//     ./main census=true soups=100000 threads=8 seed=1 out=census.json
+//
+// Each soup is a soup_size x soup_size random square (density, default 0.5) on an
+// unbounded plane, seeded from seed + soup index, so a census is reproducible
+// whatever the thread count. Soups run until they settle (or max_gens), then
+// their objects are split apart (merge_distance) and classified. Objects that are
+// in patterns_file (see PatternIndex) get their name in the census too.
+class CensusRunner {
+public:
+    explicit CensusRunner(const json& params)
+        : soups(params.value("soups", 10000L)),
+          seed(params.value("seed", 1ULL)),
+          threads(params.value("threads", int(std::max(1u, std::thread::hardware_concurrency())))),
+          outPath(params.value("out", "census.json")),
+          patternsFile(params.value("patterns_file", "../../patterns.json")) {
+        cfg.soupSize = params.value("soup_size", cfg.soupSize);
+        cfg.density = params.value("density", cfg.density);
+        cfg.maxGenerations = params.value("max_gens", cfg.maxGenerations);
+        cfg.mergeDistance = params.value("merge_distance", cfg.mergeDistance);
+        cfg.maxPeriod = params.value("max_period", cfg.maxPeriod);
+    }
+
+    int run() {
+        using Clock = std::chrono::steady_clock;
+        ThreadPool            pool(threads);
+        std::vector< Census > perSlot(pool.size());
+        auto                  t0 = Clock::now();
+        pool.parallelForStealing(soups, [&](long i, int slot) {
+            perSlot[slot].add(runSoup(SplitMix64(seed + uint64_t(i)).next(), cfg));
+        });
+        double secs = std::chrono::duration< double >(Clock::now() - t0).count();
+
+        Census total;
+        for (auto& c : perSlot) total.merge(c);
+        double perCore = secs > 0 ? total.soups / secs / pool.size() : 0.0;
+
+        PatternIndex library;
+        try {
+            library = PatternIndex::open(patternsFile);
+        } catch (const std::exception& e) {
+            std::cerr << "Census objects won't be named: " << e.what() << "\n";
+        }
+        auto nameOf = [&](uint64_t fp) {
+            const PatternIndex::Entry* e = library.find(fp);
+            return e ? library.name(*e) : std::string();
+        };
+
+        auto ranked = total.sorted();
+        std::cout << std::fixed << std::setprecision(1) << "Census: " << total.soups << " soups on " << pool.size()
+                  << " threads in " << secs << " s, " << perCore << " soups/sec/core, " << total.unsettled
+                  << " unsettled\n";
+        for (size_t i = 0; i < ranked.size() && i < 15; ++i)
+            std::cout << "  " << std::left << std::setw(28) << ranked[i].second.code << std::setw(12)
+                      << kindName(ranked[i].second.kind) << std::right << std::setw(10) << ranked[i].second.count
+                      << "  " << nameOf(ranked[i].first) << "\n";
+
+        nlohmann::ordered_json doc = {{"soups", total.soups},
+                                      {"seed", seed},
+                                      {"soup_size", cfg.soupSize},
+                                      {"density", cfg.density},
+                                      {"threads", pool.size()},
+                                      {"seconds", secs},
+                                      {"soups_per_sec_per_core", perCore},
+                                      {"generations", total.generations},
+                                      {"unsettled_soups", total.unsettled}};
+        for (int k = 0; k < 4; ++k) doc["by_kind"][kindName(ObjectKind(k))] = total.byKind[k];
+        doc["objects"] = nlohmann::ordered_json::array();
+        for (auto& [fp, e] : ranked) {
+            nlohmann::ordered_json obj = {{"code", e.code}, {"kind", kindName(e.kind)}, {"period", e.period}, {"count", e.count}};
+            if (std::string name = nameOf(fp); !name.empty()) obj["name"] = name;
+            doc["objects"].push_back(obj);
+        }
+
+        std::ofstream out(outPath);
+        out << doc.dump(2) << "\n";
+        if (!out) {
+            std::cerr << "Could not write census " << outPath << "\n";
+            return 1;
+        }
+        std::cout << "Wrote " << ranked.size() << " distinct objects to " << outPath << "\n";
+        return 0;
+    }
+
+private:
+    long         soups;
+    uint64_t     seed;
+    int          threads;
+    std::string  outPath, patternsFile;
+    CensusConfig cfg;
+};
@@ -0,0 +1,286 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../includes/thread_pool.hpp"
+#include "./life_engine.hpp"
+
+// One island of live cells.
+struct Component {
+    int                     top = 0, left = 0, bottom = 0, right = 0;  // bounding box, inclusive
+    long                    population = 0;
+    int                     words = 0;  // 64-bit words per mask row
+    std::vector< uint64_t > mask;       // height() rows; bit (c - left) of a row = cell (r, c)
+
+    int height() const { return bottom - top + 1; }
+    int width() const { return right - left + 1; }
+
+    // Board coordinates; false outside the box or if masks weren't asked for.
+    bool get(int r, int c) const {
+        if (mask.empty() || r < top || r > bottom || c < left || c > right) return false;
+        int x = c - left;
+        return mask[size_t(r - top) * words + x / 64] >> (x % 64) & 1;
+    }
+};
+
+// Splits a board into islands of live cells.
+//
+//     ComponentLabeler labeler(threads);
+//     for (const Component& obj : labeler.label(*sim, 2)) ...
+//
+// Two live cells belong to the same island when they are within mergeDistance of
+// each other in both directions (1 = plain 8-connectivity; 2 also joins things
+// separated by a single dead cell, which still interact).
+//
+// Works on runs rather than cells: a run is a stretch of a row whose live cells
+// are at most mergeDistance apart. Every column from d before a run's first cell
+// to d after its last is then within d of one of its cells, so two runs no more
+// than d rows apart connect exactly when those widened intervals overlap, and one
+// merge-walk per pair of rows finds every link. Union-find over runs instead of
+// cells keeps the forest small.
+//
+// The board is cut into bands of rows, one task each: a band exports its rows,
+// finds its runs and links them among themselves on its own; the few links across
+// band edges are added afterwards on the calling thread, then the bands tally
+// boxes, populations and masks in parallel again. Unions always point at the
+// lower run index, so every parent precedes its child and the forest within a
+// band flattens in one forward pass. Buffers are kept between calls.
+class ComponentLabeler {
+public:
+    explicit ComponentLabeler(int threads = 1, int bandRows = 64)
+        : bandRows(std::max(1, bandRows)), pool(std::make_unique< ThreadPool >(threads)) {}
+
+    // withMasks=false skips the per-island bitmaps when only counts, boxes and
+    // populations are wanted. Islands come out in row-major order of their first cell.
+    const std::vector< Component >& label(const LifeEngine& eng, int mergeDistance = 1, bool withMasks = true) {
+        R = eng.rows();
+        C = eng.cols();
+        d = std::max(1, mergeDistance);
+        int bandCount = (R + bandRows - 1) / bandRows;
+        bands.resize(bandCount);
+
+        // Runs, and links within each band.
+        pool->parallelFor(bandCount, [&](int b) { findRuns(eng, b); });
+        size_t total = 0;
+        for (Band& band : bands) {
+            band.first = uint32_t(total);
+            total += band.runs.size();
+        }
+        parent.resize(total);
+        pool->parallelFor(bandCount, [&](int b) { linkBand(b); });
+
+        // Links across band edges: the first d rows of each band against the d rows above.
+        for (int b = 1; b < bandCount; ++b)
+            for (int r = b * bandRows; r < std::min(R, b * bandRows + d); ++r)
+                for (int p = std::max(0, r - d); p < b * bandRows; ++p) linkRows(p, r);
+
+        // Islands: one per root, numbered in root order. Resized rather than
+        // rebuilt, so masks reuse their storage from the last call.
+        int count = 0;
+        rootIndex.assign(total, -1);
+        for (uint32_t i = 0; i < total; ++i)
+            if (parent[i] == i) rootIndex[i] = count++;
+        components.resize(count);
+        for (Component& c : components) c.population = 0;
+        pool->parallelFor(bandCount, [&](int b) { tallyBand(b); });
+        for (Band& band : bands)
+            for (const Box& part : band.partial) {
+                Component& c = components[part.island];
+                if (c.population == 0) {
+                    c.top = part.top;
+                    c.left = part.left;
+                    c.bottom = part.bottom;
+                    c.right = part.right;
+                    c.population = part.population;
+                } else {
+                    c.top = std::min(c.top, part.top);
+                    c.left = std::min(c.left, part.left);
+                    c.bottom = std::max(c.bottom, part.bottom);
+                    c.right = std::max(c.right, part.right);
+                    c.population += part.population;
+                }
+            }
+
+        if (withMasks) {
+            for (Component& c : components) {
+                c.words = (c.width() + 63) / 64;
+                c.mask.assign(size_t(c.height()) * c.words, 0);
+            }
+            pool->parallelFor(bandCount, [&](int b) { maskBand(b); });  // bands write disjoint mask rows
+        }
+        return components;
+    }
+
+    const std::vector< Component >& last() const { return components; }
+
+private:
+    struct Run {
+        int c0, c1;  // first and last live cell
+    };
+    struct Box {
+        int  island;
+        int  top, left, bottom, right;
+        long population;
+    };
+    struct Band {
+        uint32_t                first = 0;  // global index of runs[0]
+        std::vector< Run >      runs;
+        std::vector< uint32_t > rowStart;  // runs of row r0 + i: [rowStart[i], rowStart[i + 1])
+        std::vector< uint64_t > bits;      // this band's rows, exportRow() layout
+        std::vector< int >      comp;      // band-local root of each run, then its island
+        std::vector< int >      slot;      // band-local root -> index into partial
+        std::vector< Box >      partial;   // each island's box and population within the band
+    };
+
+    int                           bandRows;
+    std::unique_ptr< ThreadPool > pool;
+    int                           R = 0, C = 0, d = 1;
+    std::vector< Band >           bands;
+    std::vector< uint32_t >       parent;
+    std::vector< int >            rootIndex;  // island of each root run, -1 for the rest
+    std::vector< Component >      components;
+
+    int words() const { return (C + 63) / 64; }
+
+    void findRuns(const LifeEngine& eng, int b) {
+        Band& band = bands[b];
+        int   r0 = b * bandRows, r1 = std::min(R, r0 + bandRows), W = words();
+        band.bits.resize(size_t(r1 - r0) * W);
+        band.runs.clear();
+        band.rowStart.assign(1, 0);
+        for (int r = r0; r < r1; ++r) {
+            uint64_t* row = &band.bits[size_t(r - r0) * W];
+            eng.exportRow(r, row);
+            int last = -1 - d;  // column of the previous live cell
+            for (int w = 0; w < W; ++w)
+                for (uint64_t bits = row[w]; bits; bits &= bits - 1) {
+                    int c = w * 64 + __builtin_ctzll(bits);
+                    if (c - last <= d)
+                        band.runs.back().c1 = c;
+                    else
+                        band.runs.push_back({c, c});
+                    last = c;
+                }
+            band.rowStart.push_back(uint32_t(band.runs.size()));
+        }
+    }
+
+    void linkBand(int b) {
+        Band& band = bands[b];
+        for (uint32_t i = 0; i < band.runs.size(); ++i) parent[band.first + i] = band.first + i;
+        int r0 = b * bandRows, r1 = std::min(R, r0 + bandRows);
+        for (int r = r0 + 1; r < r1; ++r)
+            for (int p = std::max(r0, r - d); p < r; ++p) linkRows(p, r);
+        // Parents point backwards, so this leaves every run pointing at its band-local root.
+        band.comp.resize(band.runs.size());
+        for (uint32_t i = band.first; i < band.first + band.runs.size(); ++i) {
+            parent[i] = parent[parent[i]];
+            band.comp[i - band.first] = int(parent[i] - band.first);
+        }
+    }
+
+    // Global index range of row r's runs.
+    std::pair< uint32_t, uint32_t > rowRuns(int r) const {
+        const Band& band = bands[r / bandRows];
+        int         i = r % bandRows;
+        return {band.first + band.rowStart[i], band.first + band.rowStart[i + 1]};
+    }
+    const Run& run(uint32_t g, int r) const {
+        const Band& band = bands[r / bandRows];
+        return band.runs[g - band.first];
+    }
+
+    // Links the runs of row p (above) to those of row r.
+    void linkRows(int p, int r) {
+        auto [a, aEnd] = rowRuns(p);
+        auto [b, bEnd] = rowRuns(r);
+        while (a < aEnd && b < bEnd) {
+            const Run &A = run(a, p), &B = run(b, r);
+            if (B.c1 >= A.c0 - d && B.c0 <= A.c1 + d) unite(a, b);
+            if (A.c1 < B.c1)  // the one that ends first can't reach anything further on
+                ++a;
+            else
+                ++b;
+        }
+    }
+
+    // Path halving. While bands link on their own, every run and parent involved
+    // is inside the band, so concurrent bands never touch the same entries.
+    uint32_t find(uint32_t i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    }
+
+    void unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a < b)
+            parent[b] = a;
+        else if (b < a)
+            parent[a] = b;
+    }
+
+    // Read-only root lookup, safe from every band at once. Band-local trees are
+    // already flat, so only links across band edges add hops.
+    uint32_t root(uint32_t i) const {
+        while (parent[i] != i) i = parent[i];
+        return i;
+    }
+
+    // Everything within a band that shares a band-local root shares an island, so
+    // partial boxes are found by array lookup instead of hashing island numbers.
+    void tallyBand(int b) {
+        Band& band = bands[b];
+        band.slot.assign(band.runs.size(), -1);
+        band.partial.clear();
+        int r0 = b * bandRows;
+        for (size_t row = 0; row + 1 < band.rowStart.size(); ++row) {
+            const uint64_t* bits = &band.bits[row * words()];
+            int             r = r0 + int(row);
+            for (uint32_t i = band.rowStart[row]; i < band.rowStart[row + 1]; ++i) {
+                const Run& run = band.runs[i];
+                int&       s = band.slot[band.comp[i]];
+                if (s < 0) {
+                    s = int(band.partial.size());
+                    band.partial.push_back({rootIndex[root(band.first + band.comp[i])], r, run.c0, r, run.c1, 0});
+                }
+                Box& box = band.partial[s];
+                box.bottom = r;
+                box.left = std::min(box.left, run.c0);
+                box.right = std::max(box.right, run.c1);
+                for (int w = run.c0 / 64; w <= run.c1 / 64; ++w)
+                    box.population += __builtin_popcountll(bits[w] & spanMask(w, run.c0, run.c1));
+                band.comp[i] = box.island;
+            }
+        }
+    }
+
+    void maskBand(int b) {
+        Band& band = bands[b];
+        int   r0 = b * bandRows;
+        for (size_t row = 0; row + 1 < band.rowStart.size(); ++row)
+            for (uint32_t i = band.rowStart[row]; i < band.rowStart[row + 1]; ++i) {
+                const Run&      run = band.runs[i];
+                Component&      c = components[band.comp[i]];
+                uint64_t*       dst = &c.mask[size_t(r0 + int(row) - c.top) * c.words];
+                const uint64_t* bits = &band.bits[row * words()];
+                for (int col = run.c0; col <= run.c1;) {
+                    int      w = col / 64, take = std::min(run.c1 + 1, (w + 1) * 64) - col;
+                    uint64_t chunk = (bits[w] >> (col % 64)) & (take == 64 ? ~uint64_t(0) : (uint64_t(1) << take) - 1);
+                    int      x = col - c.left;  // shift the chunk to bit x of the mask row
+                    dst[x / 64] |= chunk << (x % 64);
+                    if (x % 64 && x / 64 + 1 < c.words) dst[x / 64 + 1] |= chunk >> (64 - x % 64);
+                    col += take;
+                }
+            }
+    }
+
+    // Bits of word w that fall within columns [c0, c1].
+    static uint64_t spanMask(int w, int c0, int c1) {
+        int      lo = std::max(c0 - w * 64, 0), hi = std::min(c1 - w * 64, 63);
+        uint64_t upper = hi == 63 ? ~uint64_t(0) : (uint64_t(1) << (hi + 1)) - 1;
+        return upper & (~uint64_t(0) << lo);
+    }
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Notices when a run has settled into a still life (period 1) or an oscillator.
+//
+//     CycleDetector cycles(64, 16);
+//     cycles.observe(0, boardHash(eng));
+//     for (long g = 0; g < last;) {
+//         long n = std::min(last, cycles.next(g)) - g;  // fuse up to the next sample
+//         eng.stepMany(int(n));
+//         g += n;
+//         if (g == cycles.next(g) && cycles.observe(g, boardHash(eng))) break;
+//     }
+//     // From cycles.start() on, the board repeats every cycles.period() generations:
+//     // generation N looks exactly like generation cycles.equivalent(N).
+//
+// Hashing a whole board costs about as much as stepping it, more than a step of
+// the incremental or sparse engines, so with a stride > 1 only every stride-th
+// generation is hashed and the engine can step fused batches in between. A
+// period-P board repeats among those samples too, within P samples; that repeat
+// only says the board is periodic, so the detector then asks for single
+// generations (next() is one ahead) and finds the exact period the same way as
+// with stride 1. The cycle is known to have started by the earlier of the two
+// matching samples, so start() can be up to stride - 1 generations late.
+//
+// With stride 1 it keeps the hashes of the last maxPeriod generations. A repeat
+// at distance P makes P a candidate; it is confirmed once the following P
+// generations repeat too, which also rules out a 64-bit hash collision.
+// Observations must come at next(); a gap (or reset(), e.g. after the user edits
+// the board) starts over. Periods longer than maxPeriod, such as spaceships on a
+// torus, are not seen.
+class CycleDetector {
+public:
+    explicit CycleDetector(int maxPeriod = 64, int stride = 1)
+        : maxP(maxPeriod), stride(std::max(1, stride)), step(std::max(1, stride)), ring(size_t(maxPeriod) + 1) {}
+
+    // The generation to observe next when the board is at `gen`: `gen` itself if
+    // nothing has been observed since the last reset.
+    long next(long gen) const { return lastGen < 0 ? gen : lastGen + step; }
+
+    // Records the hash of generation `gen`. Returns true once a cycle is confirmed.
+    bool observe(long gen, uint64_t hash) {
+        if (confirmed) return true;
+        if (lastGen < 0 || gen != lastGen + step) reset();
+        lastGen = gen;
+
+        if (step > 1) {
+            for (int p = 1; p <= std::min< long >(maxP, filled); ++p)
+                if (hashAt(filled - p) == hash) {
+                    // Periodic from gen - p * stride on; narrow it down a generation at a time.
+                    sampledStart = gen - p * stride;
+                    sampledSpan = p * stride;
+                    singleFrom = gen;
+                    step = 1;
+                    filled = 0;
+                    break;
+                }
+            return push(hash), false;
+        }
+
+        if (candidate > 0 && hashAt(filled - candidate) != hash) candidate = 0;
+        if (candidate > 0 && gen - cycleStart >= 2 * candidate) {
+            confirmed = true;
+            if (sampledStart >= 0 && sampledSpan % candidate == 0) cycleStart = std::min(cycleStart, sampledStart);
+        }
+        for (int p = 1; candidate == 0 && p <= std::min< long >(maxP, filled); ++p)
+            if (hashAt(filled - p) == hash) {
+                candidate = p;
+                cycleStart = gen - p;
+            }
+        // A sampled repeat that single generations can't confirm was a collision.
+        if (!confirmed && stride > 1 && candidate == 0 && gen - singleFrom > 2 * maxP) reset(), lastGen = gen;
+        push(hash);
+        return confirmed;
+    }
+
+    void reset() {
+        filled = 0;
+        candidate = 0;
+        confirmed = false;
+        lastGen = -2;
+        step = stride;
+        sampledStart = -1;
+    }
+
+    bool settled() const { return confirmed; }
+    int  period() const { return confirmed ? candidate : 0; }  // 1 = still life
+    long start() const { return confirmed ? cycleStart : -1; }  // first generation of the cycle
+    long confirmedAt() const { return confirmed ? lastGen : -1; }
+
+    // The generation at or after start() whose board equals generation n's.
+    long equivalent(long n) const { return n < cycleStart ? n : cycleStart + (n - cycleStart) % candidate; }
+
+private:
+    int                     maxP, stride;
+    int                     step;  // generations between observations: stride, or 1 while confirming
+    std::vector< uint64_t > ring;  // hash of observation i at i % size
+    long                    filled = 0;  // observations in this run
+    long                    lastGen = -2;
+    int                     candidate = 0;
+    long                    cycleStart = -1;
+    bool                    confirmed = false;
+    long                    sampledStart = -1, sampledSpan = 0;  // the sampled repeat that started confirming
+    long                    singleFrom = 0;
+
+    uint64_t hashAt(long i) const { return ring[size_t(i % long(ring.size()))]; }
+
+    void push(uint64_t hash) { ring[size_t(filled++ % long(ring.size()))] = hash; }
+};
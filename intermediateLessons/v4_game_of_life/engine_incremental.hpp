@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "./life_engine.hpp"
+
+// Keeps every cell's live-neighbour count up to date instead of recounting it.
+//
+// A cell's next state depends only on its own state and its neighbour count, and
+// those only change when the cell or one of its neighbours flipped. So each
+// generation only looks at the cells that flipped last time and their
+// neighbours; a birth or death then adds or subtracts one from the counts of its
+// eight neighbours. A generation costs O(cells that changed), not O(area): still
+// lifes and empty space are free, a few gliders on a huge board are cheap, and a
+// dense soup is slower than the tiled engines.
+class IncrementalEngine : public LifeEngine {
+public:
+    IncrementalEngine(int rows, int cols, const EngineConfig& cfg)
+        : R(rows), C(cols), boundary(cfg.boundary),
+          alive(size_t(rows) * cols, 0), count(alive.size(), 0), queued(alive.size(), 0) {}
+
+    std::string name() const override { return "incremental"; }
+    int         rows() const override { return R; }
+    int         cols() const override { return C; }
+    bool        get(int r, int c) const override { return alive[size_t(r) * C + c]; }
+    long        population() const override { return pop; }
+
+    void set(int r, int c, bool live) override {
+        uint32_t i = uint32_t(r) * C + c;
+        if (bool(alive[i]) == live) return;
+        flip(i);
+        changed.push_back(i);
+    }
+
+    size_t bytes() const override {
+        return alive.size() * 3 + (changed.capacity() + candidates.capacity() + flips.capacity()) * sizeof(uint32_t);
+    }
+
+    void exportRow(int r, uint64_t* words) const override { packRow(&alive[size_t(r) * C], C, words); }
+
+    void step() override {
+        // Everything whose state or count moved last generation, once each.
+        candidates.clear();
+        for (uint32_t i : changed) {
+            enqueue(i);
+            forEachNeighbour(i, [&](uint32_t n) { enqueue(n); });
+        }
+
+        // Decide every flip against this generation's counts before applying any.
+        flips.clear();
+        for (uint32_t i : candidates) {
+            queued[i] = 0;
+            bool next = count[i] == 3 || (alive[i] && count[i] == 2);
+            if (next != bool(alive[i])) flips.push_back(i);
+        }
+        for (uint32_t i : flips) flip(i);
+        changed.swap(flips);
+    }
+
+    // Cells that flipped in the last generation (or were set since).
+    size_t changes() const { return changed.size(); }
+
+private:
+    int                     R, C;
+    Boundary                boundary;
+    std::vector< uint8_t >  alive, count;
+    std::vector< uint8_t >  queued;  // already in candidates this generation
+    std::vector< uint32_t > changed, candidates, flips;
+    long                    pop = 0;
+
+    void enqueue(uint32_t i) {
+        if (queued[i]) return;
+        queued[i] = 1;
+        candidates.push_back(i);
+    }
+
+    void flip(uint32_t i) {
+        alive[i] ^= 1;
+        int d = alive[i] ? 1 : -1;
+        pop += d;
+        forEachNeighbour(i, [&](uint32_t n) { count[n] = uint8_t(count[n] + d); });
+    }
+
+    // Same eight neighbours Grid::countNeighbors() looks at, duplicates and all
+    // on wrapped boards narrower than three cells.
+    template < typename F >
+    void forEachNeighbour(uint32_t i, F&& fn) const {
+        int r = int(i / C), c = int(i % C);
+        if (r > 0 && r < R - 1 && c > 0 && c < C - 1) {
+            for (uint32_t n : {i - C - 1, i - C, i - C + 1, i - 1, i + 1, i + C - 1, i + C, i + C + 1}) fn(n);
+            return;
+        }
+        for (int dr = -1; dr <= 1; ++dr)
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (dr == 0 && dc == 0) continue;
+                int rr = r + dr, cc = c + dc;
+                if (boundary == Boundary::Wrap) {
+                    rr = (rr + R) % R;
+                    cc = (cc + C) % C;
+                } else if (rr < 0 || rr >= R || cc < 0 || cc >= C)
+                    continue;
+                fn(uint32_t(rr) * C + cc);
+            }
+    }
+};
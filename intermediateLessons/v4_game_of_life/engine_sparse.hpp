@@ -0,0 +1,150 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "./life_engine.hpp"
+
+// Live cells only, as a sorted array of packed 64-bit (row, col) keys. Nothing
+// is stored for dead space, so memory follows the population, not the board.
+//
+// A generation: every live cell emits the keys of its eight neighbours, the
+// candidates are radix sorted, and the length of each run of equal keys is that
+// cell's neighbour count. Runs of 3, and runs of 2 on a live cell (found by
+// walking the sorted live array alongside), make the next generation, already in
+// sorted order.
+//
+// With cfg.unbounded the board has no edges at all: rows()/cols() only describe
+// the window onto it, get()/set()/exportRow() look through that window at the
+// origin, and cells outside it keep evolving. Coordinates are 32-bit signed.
+class SparseEngine : public LifeEngine {
+public:
+    SparseEngine(int rows, int cols, const EngineConfig& cfg)
+        : R(rows), C(cols), boundary(cfg.boundary), unbounded(cfg.unbounded) {}
+
+    std::string name() const override { return "sparse"; }
+    int         rows() const override { return R; }
+    int         cols() const override { return C; }
+    long        population() const override { return long(live.size()); }
+
+    size_t bytes() const override {
+        return (live.capacity() + next.capacity() + cand.capacity() + tmp.capacity()) * sizeof(uint64_t);
+    }
+
+    bool get(int r, int c) const override { return std::binary_search(live.begin(), live.end(), key(r, c)); }
+
+    void set(int r, int c, bool alive) override {
+        uint64_t k = key(r, c);
+        auto     it = std::lower_bound(live.begin(), live.end(), k);  // row-major seeding appends at the end
+        bool     present = it != live.end() && *it == k;
+        if (alive && !present)
+            live.insert(it, k);
+        else if (!alive && present)
+            live.erase(it);
+    }
+
+    void exportRow(int r, uint64_t* words) const override {
+        std::fill_n(words, (C + 63) / 64, uint64_t(0));
+        for (auto it = std::lower_bound(live.begin(), live.end(), key(r, 0)); it != live.end() && rowOf(*it) == r; ++it)
+            if (int c = colOf(*it); c >= 0 && c < C) words[c / 64] |= uint64_t(1) << (c % 64);
+    }
+
+    void step() override {
+        cand.clear();
+        cand.reserve(live.size() * 8);
+        for (uint64_t k : live) {
+            int r = rowOf(k), c = colOf(k);
+            for (int dr = -1; dr <= 1; ++dr)
+                for (int dc = -1; dc <= 1; ++dc) {
+                    if (dr == 0 && dc == 0) continue;
+                    int rr = r + dr, cc = c + dc;
+                    if (!unbounded) {
+                        if (boundary == Boundary::Wrap) {
+                            rr = (rr + R) % R;
+                            cc = (cc + C) % C;
+                        } else if (rr < 0 || rr >= R || cc < 0 || cc >= C)
+                            continue;
+                    }
+                    cand.push_back(key(rr, cc));
+                }
+        }
+        radixSort(cand, tmp);
+
+        next.clear();
+        size_t li = 0;
+        for (size_t i = 0; i < cand.size();) {
+            size_t j = i;
+            while (j < cand.size() && cand[j] == cand[i]) ++j;
+            while (li < live.size() && live[li] < cand[i]) ++li;
+            size_t n = j - i;
+            if (n == 3 || (n == 2 && li < live.size() && live[li] == cand[i])) next.push_back(cand[i]);
+            i = j;
+        }
+        live.swap(next);
+    }
+
+    // Smallest rectangle holding every live cell: {minRow, minCol, maxRow, maxCol}.
+    // All zero for an empty board.
+    std::array< int, 4 > bounds() const {
+        if (live.empty()) return {0, 0, 0, 0};
+        int minC = std::numeric_limits< int >::max(), maxC = std::numeric_limits< int >::min();
+        for (uint64_t k : live) {
+            minC = std::min(minC, colOf(k));
+            maxC = std::max(maxC, colOf(k));
+        }
+        return {rowOf(live.front()), minC, rowOf(live.back()), maxC};
+    }
+
+    // Every live cell, sorted; decode with rowOf() / colOf().
+    const std::vector< uint64_t >& liveKeys() const { return live; }
+
+    // Flipping the sign bits makes unsigned key order match signed (row, col) order.
+    static uint64_t key(int r, int c) {
+        return uint64_t(uint32_t(r) ^ 0x80000000u) << 32 | (uint32_t(c) ^ 0x80000000u);
+    }
+    static int rowOf(uint64_t k) { return int(uint32_t(k >> 32) ^ 0x80000000u); }
+    static int colOf(uint64_t k) { return int(uint32_t(k) ^ 0x80000000u); }
+
+private:
+    int                     R, C;
+    Boundary                boundary;
+    bool                    unbounded;
+    std::vector< uint64_t > live;             // sorted, unique
+    std::vector< uint64_t > next, cand, tmp;  // scratch, kept between generations
+
+    // LSD radix sort, one byte per pass, on each key's distance from the smallest
+    // one. Bytes above the largest distance are never looked at, and passes where
+    // every key has the same byte are skipped. Sorting the raw keys would do
+    // all eight passes as soon as the cells straddle row or column 0, where every
+    // byte flips (0x7fffffff / 0x80000000), which an unbounded soup always does.
+    static void radixSort(std::vector< uint64_t >& keys, std::vector< uint64_t >& scratch) {
+        if (keys.size() < 256) {
+            std::sort(keys.begin(), keys.end());
+            return;
+        }
+        auto [lo, hi] = std::minmax_element(keys.begin(), keys.end());
+        uint64_t base = *lo, span = *hi - *lo;
+        int      bytes = 0;  // bytes above these are 0 in every distance
+        while (bytes < 8 && (span >> (8 * bytes)) != 0) ++bytes;
+
+        size_t counts[8][256] = {};
+        for (uint64_t k : keys)
+            for (int b = 0; b < bytes; ++b) ++counts[b][((k - base) >> (8 * b)) & 0xff];
+
+        scratch.resize(keys.size());
+        for (int b = 0; b < bytes; ++b) {
+            size_t* count = counts[b];
+            if (count[((keys[0] - base) >> (8 * b)) & 0xff] == keys.size()) continue;
+            size_t offset = 0;
+            for (int v = 0; v < 256; ++v) {
+                size_t n = count[v];
+                count[v] = offset;
+                offset += n;
+            }
+            for (uint64_t k : keys) scratch[count[((k - base) >> (8 * b)) & 0xff]++] = k;
+            keys.swap(scratch);
+        }
+    }
+};
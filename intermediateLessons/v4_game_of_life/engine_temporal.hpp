@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../includes/thread_pool.hpp"
+#include "./life_engine.hpp"
+
+// Temporally blocked version of the tiled engine, for boards far bigger than the
+// caches.
+//
+// A plain step streams the whole board through memory once per generation. Here
+// each tile is copied into a small scratch buffer together with a halo `depth`
+// cells wide, stepped `depth` generations there (the valid area shrinks by one
+// cell per generation, which is what the halo pays for), and only the tile
+// itself is written back. The board is read and written once per `depth`
+// generations instead of once per generation, at the price of recomputing the
+// halo cells in each tile.
+//
+// Boundary::Dead: cells past the edge are loaded as dead and never written, so
+// they stay dead in every generation. Boundary::Wrap: the halo is gathered from
+// the opposite edges and evolves like any other cell.
+class TemporalEngine : public LifeEngine {
+public:
+    TemporalEngine(int rows, int cols, const EngineConfig& cfg)
+        : R(rows), C(cols), tile(std::max(1, cfg.tile)), depth(std::max(1, cfg.depth)),
+          boundary(cfg.boundary), cur(size_t(rows) * cols, 0), next(cur.size(), 0),
+          pool(std::make_unique< ThreadPool >(cfg.threads)) {}
+
+    std::string name() const override { return "temporal"; }
+    int         rows() const override { return R; }
+    int         cols() const override { return C; }
+    bool        get(int r, int c) const override { return cur[size_t(r) * C + c]; }
+    void        set(int r, int c, bool alive) override { cur[size_t(r) * C + c] = alive; }
+    size_t      bytes() const override { return cur.size() + next.size(); }  // plus one scratch tile per thread
+
+    void exportRow(int r, uint64_t* words) const override { packRow(&cur[size_t(r) * C], C, words); }
+
+    long population() const override {
+        long n = 0;
+        for (uint8_t v : cur) n += v;
+        return n;
+    }
+
+    void step() override { pass(1); }
+
+    void stepMany(int n) override {
+        for (; n > 0; n -= depth) pass(std::min(n, depth));
+    }
+
+private:
+    int                           R, C;
+    int                           tile, depth;
+    Boundary                      boundary;
+    std::vector< uint8_t >        cur, next;
+    std::unique_ptr< ThreadPool > pool;
+
+    // k generations, every tile from cur into next.
+    void pass(int k) {
+        int tilesDown = (R + tile - 1) / tile, tilesAcross = (C + tile - 1) / tile;
+        pool->parallelFor(tilesDown * tilesAcross, [&](int t) {
+            stepBlock((t / tilesAcross) * tile, (t % tilesAcross) * tile, k);
+        });
+        cur.swap(next);
+    }
+
+    void stepBlock(int r0, int c0, int k) {
+        // Scratch pair per thread, reused across tiles, passes and engines.
+        thread_local std::vector< uint8_t > bufA, bufB;
+
+        int r1 = std::min(R, r0 + tile), c1 = std::min(C, c0 + tile);
+        int H = r1 - r0 + 2 * k, W = c1 - c0 + 2 * k;  // tile plus halo
+        bufA.assign(size_t(H) * W, 0);
+        bufB.assign(size_t(H) * W, 0);
+
+        // Local (i, j) is board cell (r0 - k + i, c0 - k + j).
+        for (int i = 0; i < H; ++i) {
+            int gr = r0 - k + i;
+            if (boundary == Boundary::Wrap)
+                gr = ((gr % R) + R) % R;
+            else if (gr < 0 || gr >= R)
+                continue;
+            const uint8_t* src = &cur[size_t(gr) * C];
+            uint8_t*       dst = &bufA[size_t(i) * W];
+            for (int j = 0; j < W; ++j) {
+                int gc = c0 - k + j;
+                if (boundary == Boundary::Wrap)
+                    dst[j] = src[((gc % C) + C) % C];
+                else if (gc >= 0 && gc < C)
+                    dst[j] = src[gc];
+            }
+        }
+
+        uint8_t *a = bufA.data(), *b = bufB.data();
+        for (int g = 1; g <= k; ++g) {
+            int iLo = g, iHi = H - g, jLo = g, jHi = W - g;
+            if (boundary == Boundary::Dead) {  // off-board cells are never computed, so stay 0
+                iLo = std::max(iLo, k - r0);
+                iHi = std::min(iHi, k - r0 + R);
+                jLo = std::max(jLo, k - c0);
+                jHi = std::min(jHi, k - c0 + C);
+            }
+            for (int i = iLo; i < iHi; ++i) {
+                const uint8_t* up = a + size_t(i - 1) * W;
+                const uint8_t* mid = a + size_t(i) * W;
+                const uint8_t* dn = a + size_t(i + 1) * W;
+                uint8_t*       out = b + size_t(i) * W;
+                for (int j = jLo; j < jHi; ++j) {
+                    int n = up[j - 1] + up[j] + up[j + 1] + mid[j - 1] + mid[j + 1] + dn[j - 1] + dn[j] + dn[j + 1];
+                    out[j] = uint8_t((n == 3) | (mid[j] & (n == 2)));
+                }
+            }
+            std::swap(a, b);
+        }
+
+        for (int r = r0; r < r1; ++r)
+            std::copy_n(a + size_t(r - r0 + k) * W + k, c1 - c0, &next[size_t(r) * C + c0]);
+    }
+};
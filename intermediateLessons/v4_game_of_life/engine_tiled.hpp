@@ -0,0 +1,82 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../includes/thread_pool.hpp"
+#include "./life_engine.hpp"
+
+// One byte per cell on a board padded with a one-cell border, stepped tile by
+// tile across a thread pool.
+//
+// The border ("halo") is refreshed before every generation: all dead for
+// Boundary::Dead, a copy of the opposite edge for Boundary::Wrap. That keeps the
+// inner loop free of edge checks: every cell just sums its eight neighbours.
+class TiledEngine : public LifeEngine {
+public:
+    TiledEngine(int rows, int cols, const EngineConfig& cfg)
+        : R(rows), C(cols), W(cols + 2),
+          tile(std::max(1, cfg.tile)), boundary(cfg.boundary),
+          cur(size_t(rows + 2) * (cols + 2), 0), next(cur.size(), 0),
+          pool(std::make_unique< ThreadPool >(cfg.threads)) {}
+
+    std::string name() const override { return "tiled"; }
+    int         rows() const override { return R; }
+    int         cols() const override { return C; }
+    bool        get(int r, int c) const override { return cur[at(r, c)]; }
+    void        set(int r, int c, bool alive) override { cur[at(r, c)] = alive; }
+    size_t      bytes() const override { return cur.size() + next.size(); }
+
+    void exportRow(int r, uint64_t* words) const override { packRow(&cur[at(r, 0)], C, words); }
+
+    long population() const override {
+        long n = 0;
+        for (int r = 0; r < R; ++r)
+            for (int c = 0; c < C; ++c) n += cur[at(r, c)];
+        return n;
+    }
+
+    void step() override {
+        fillHalo();
+        int tilesDown = (R + tile - 1) / tile, tilesAcross = (C + tile - 1) / tile;
+        pool->parallelFor(tilesDown * tilesAcross, [&](int t) {
+            stepBlock((t / tilesAcross) * tile, (t % tilesAcross) * tile);
+        });
+        cur.swap(next);
+    }
+
+private:
+    int                           R, C, W;  // W = padded row stride
+    int                           tile;
+    Boundary                      boundary;
+    std::vector< uint8_t >        cur, next;
+    std::unique_ptr< ThreadPool > pool;
+
+    size_t at(int r, int c) const { return size_t(r + 1) * W + (c + 1); }
+
+    void fillHalo() {
+        if (boundary == Boundary::Dead) return;  // the border is never written, so it stays 0
+        for (int r = 0; r < R; ++r) {
+            cur[at(r, -1)] = cur[at(r, C - 1)];
+            cur[at(r, C)] = cur[at(r, 0)];
+        }
+        // Whole padded rows, corners included.
+        std::copy_n(&cur[at(R - 1, -1)], W, &cur[at(-1, -1)]);
+        std::copy_n(&cur[at(0, -1)], W, &cur[at(R, -1)]);
+    }
+
+    void stepBlock(int r0, int c0) {
+        int r1 = std::min(R, r0 + tile), c1 = std::min(C, c0 + tile);
+        for (int r = r0; r < r1; ++r) {
+            const uint8_t* up = &cur[at(r - 1, 0)];
+            const uint8_t* mid = &cur[at(r, 0)];
+            const uint8_t* dn = &cur[at(r + 1, 0)];
+            uint8_t*       out = &next[at(r, 0)];
+            for (int c = c0; c < c1; ++c) {
+                int n = up[c - 1] + up[c] + up[c + 1] + mid[c - 1] + mid[c + 1] + dn[c - 1] + dn[c] + dn[c + 1];
+                out[c] = uint8_t((n == 3) | (mid[c] & (n == 2)));
+            }
+        }
+    }
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./engine_incremental.hpp"
+#include "./engine_sparse.hpp"
+#include "./engine_temporal.hpp"
+#include "./engine_tiled.hpp"
+#include "./grid.hpp"
+#include "./life_engine.hpp"
+
+// The teaching Grid: per-cell neighbour counts over vector<vector<bool>>, plus
+// the packed mirror and stats it keeps for queries. Everything else is checked
+// against this one.
+class ReferenceEngine : public LifeEngine {
+public:
+    ReferenceEngine(int rows, int cols, const EngineConfig& cfg) : grid(cols, rows, 1, cfg.boundary) {}
+
+    std::string name() const override { return "reference"; }
+    int         rows() const override { return grid.rowCount(); }
+    int         cols() const override { return grid.colCount(); }
+    bool        get(int r, int c) const override { return grid.isAlive(r, c); }
+    void        set(int r, int c, bool alive) override { grid.setCell(r, c, alive); }
+    void        step() override { grid.update(); }
+    long        population() const override { return grid.population(); }
+    size_t      bytes() const override { return grid.bytes(); }
+
+    void exportRow(int r, uint64_t* words) const override {
+        std::copy_n(grid.packedRow(r), (cols() + 63) / 64, words);
+    }
+    const GenerationStats* lastStats() const override { return &grid.lastStats(); }
+
+private:
+    Grid grid;
+};
+
+struct EngineInfo {
+    // Which EngineConfig fields the engine uses, plus kSparse, which is not a knob
+    // but a warning: cost and memory follow the population, not the area.
+    enum Knobs : unsigned { kThreads = 1, kTile = 2, kDepth = 4, kUnbounded = 8, kSparse = 16 };
+
+    std::string                                                                    name;
+    unsigned                                                                       knobs;
+    std::function< std::unique_ptr< LifeEngine >(int, int, const EngineConfig&) > make;
+};
+
+template < typename E >
+std::unique_ptr< LifeEngine > makeEngineOf(int rows, int cols, const EngineConfig& cfg) {
+    return std::make_unique< E >(rows, cols, cfg);
+}
+
+// Every update path in the tree. New engines register here and are picked up by
+// bench_grid, verify_engines, the auto-tuner and anything else that loops over engines.
+inline const std::vector< EngineInfo >& engineRegistry() {
+    static const std::vector< EngineInfo > engines = {
+        {"reference", 0, makeEngineOf< ReferenceEngine >},
+        {"tiled", EngineInfo::kThreads | EngineInfo::kTile, makeEngineOf< TiledEngine >},
+        {"incremental", 0, makeEngineOf< IncrementalEngine >},
+        {"sparse", EngineInfo::kUnbounded | EngineInfo::kSparse, makeEngineOf< SparseEngine >},
+        {"temporal", EngineInfo::kThreads | EngineInfo::kTile | EngineInfo::kDepth, makeEngineOf< TemporalEngine >},
+    };
+    return engines;
+}
+
+inline std::unique_ptr< LifeEngine > makeEngine(const std::string& name, int rows, int cols, const EngineConfig& cfg = {}) {
+    for (auto& e : engineRegistry())
+        if (e.name == name) return e.make(rows, cols, cfg);
+    return nullptr;
+}
@@ -0,0 +1,298 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./components.hpp"
+#include "./engine_sparse.hpp"
+#include "./patterns.hpp"
+
+using Cell = std::pair< int, int >;  // (row, col)
+
+// A cell set moved to the origin: h rows of `words` 64-bit masks, bit c of a row
+// (word c / 64) = column c.
+struct Shape {
+    int                     h = 0, w = 0, words = 0;
+    std::vector< uint64_t > rows;
+
+    bool operator<(const Shape& o) const { return std::tie(h, w, rows) < std::tie(o.h, o.w, o.rows); }
+    bool operator==(const Shape& o) const { return h == o.h && w == o.w && rows == o.rows; }
+};
+
+// Shape of `cells` under one of the 8 symmetries of the square (bit 0: swap rows
+// and columns, bit 1: flip rows, bit 2: flip columns), translated to the origin.
+inline Shape shapeOf(const std::vector< Cell >& cells, int symmetry) {
+    Shape s;
+    if (cells.empty()) return s;
+    auto place = [symmetry](Cell rc) {
+        auto [r, c] = rc;
+        if (symmetry & 1) std::swap(r, c);
+        return Cell{symmetry & 2 ? -r : r, symmetry & 4 ? -c : c};
+    };
+    Cell p = place(cells[0]);
+    int  r0 = p.first, c0 = p.second, r1 = r0, c1 = c0;
+    for (const Cell& rc : cells) {
+        auto [r, c] = place(rc);
+        r0 = std::min(r0, r), r1 = std::max(r1, r);
+        c0 = std::min(c0, c), c1 = std::max(c1, c);
+    }
+    s.h = r1 - r0 + 1;
+    s.w = c1 - c0 + 1;
+    s.words = (s.w + 63) / 64;
+    s.rows.assign(size_t(s.h) * s.words, 0);
+    for (const Cell& rc : cells) {
+        auto [r, c] = place(rc);
+        int x = c - c0;
+        s.rows[size_t(r - r0) * s.words + x / 64] |= uint64_t(1) << (x % 64);
+    }
+    return s;
+}
+
+// The same object in any position, rotation or reflection gives the same shape:
+// the smallest of its 8 symmetric images.
+inline Shape canonicalShape(const std::vector< Cell >& cells) {
+    Shape best = shapeOf(cells, 0);
+    for (int sym = 1; sym < 8; ++sym)
+        if (Shape s = shapeOf(cells, sym); s < best) best = std::move(s);
+    return best;
+}
+
+// 64-bit hash of a (canonical) shape.
+inline uint64_t fingerprint(const Shape& s) {
+    auto mix = [](uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        return h ^ (h >> 33);
+    };
+    uint64_t h = mix(uint64_t(uint32_t(s.h)) << 32 | uint32_t(s.w));
+    for (uint64_t w : s.rows) h = mix(h ^ w) + 0x9e3779b97f4a7c15ULL;
+    return h;
+}
+
+inline uint64_t fingerprint(const std::vector< Cell >& cells) { return fingerprint(canonicalShape(cells)); }
+
+// Rows in hex, '.' between rows; wide rows print their high words first.
+inline std::string shapeCode(const Shape& s) {
+    std::string code;
+    char        hex[20];
+    for (int r = 0; r < s.h; ++r) {
+        if (r) code += '.';
+        bool lead = true;
+        for (int w = s.words - 1; w >= 0; --w) {
+            uint64_t bits = s.rows[size_t(r) * s.words + w];
+            if (lead && bits == 0 && w > 0) continue;
+            std::snprintf(hex, sizeof(hex), lead ? "%llx" : "%016llx", static_cast< unsigned long long >(bits));
+            code += hex;
+            lead = false;
+        }
+    }
+    return code;
+}
+
+inline std::vector< Cell > cellsOf(const Pattern& p) {
+    std::vector< Cell > out;
+    for (auto [x, y] : p.cells) out.push_back({y, x});
+    return out;
+}
+
+inline std::vector< Cell > cellsOf(const Component& c) {
+    std::vector< Cell > out;
+    for (int r = c.top; r <= c.bottom; ++r)
+        for (int w = 0; w < c.words; ++w)
+            for (uint64_t bits = c.mask[size_t(r - c.top) * c.words + w]; bits; bits &= bits - 1)
+                out.push_back({r, c.left + w * 64 + __builtin_ctzll(bits)});
+    return out;
+}
+
+// How an object repeats on its own, on an unbounded plane.
+struct Periodicity {
+    int                                period = 0;  // 0: didn't repeat within maxPeriod (or died)
+    bool                               moves = false;
+    std::vector< std::vector< Cell > > phases;  // generations 0 .. period - 1 (just 0 if period is 0)
+};
+
+// Runs `cells` alone until it comes back to its starting shape: in the same
+// place (still life, oscillator) or shifted (spaceship).
+inline Periodicity findPeriod(const std::vector< Cell >& cells, int maxPeriod) {
+    EngineConfig cfg;
+    cfg.unbounded = true;
+    SparseEngine eng(1, 1, cfg);
+    for (auto [r, c] : cells) eng.set(r, c, true);
+
+    auto toCells = [](const std::vector< uint64_t >& keys) {
+        std::vector< Cell > out;
+        for (uint64_t k : keys) out.push_back({SparseEngine::rowOf(k), SparseEngine::colOf(k)});
+        return out;
+    };
+    // Keys relative to the first live cell: equal iff same shape, wherever it is.
+    auto normalized = [](const std::vector< uint64_t >& keys) {
+        std::vector< uint64_t > out;
+        int                     r0 = SparseEngine::rowOf(keys[0]), c0 = SparseEngine::colOf(keys[0]);
+        for (uint64_t k : keys) out.push_back(SparseEngine::key(SparseEngine::rowOf(k) - r0, SparseEngine::colOf(k) - c0));
+        return out;
+    };
+
+    Periodicity p;
+    if (cells.empty()) return p;
+    std::vector< uint64_t > start = eng.liveKeys(), first = normalized(start);
+    p.phases.push_back(toCells(start));
+    for (int g = 1; g <= maxPeriod; ++g) {
+        eng.step();
+        if (eng.population() == 0) break;
+        if (normalized(eng.liveKeys()) == first) {
+            p.period = g;
+            p.moves = eng.liveKeys()[0] != start[0];
+            return p;
+        }
+        p.phases.push_back(toCells(eng.liveKeys()));
+    }
+    p.phases.resize(1);
+    return p;
+}
+
+// Fingerprints of every patterns.json entry, for naming objects found on a board
+// in O(1): canonicalize what was found, then look it up.
+//
+//     PatternIndex index = PatternIndex::open("../../patterns.json");
+//     if (auto* e = index.find(fingerprint(cellsOf(component)))) ... index.name(*e)
+//
+// Entries that repeat on their own (still lifes, oscillators, spaceships) are
+// indexed in every phase, so a blinker or glider is recognised whichever phase
+// it is caught in. The rest (methuselahs, guns) only in the shape given. When
+// two entries share a fingerprint the first in the file wins.
+//
+// open() keeps a binary copy next to the JSON (patterns.json.idx) and loads that
+// instead of re-running every pattern when the JSON hasn't changed.
+class PatternIndex {
+public:
+    struct Entry {
+        uint32_t name;    // which pattern, for name()
+        uint16_t phase;   // generation of the entry this shape is
+        uint16_t period;  // 0 if it doesn't repeat
+    };
+
+    void build(const std::vector< Pattern >& patterns, int maxPeriod = 64) {
+        table.clear();
+        names.clear();
+        for (const Pattern& p : patterns) {
+            uint32_t    id = uint32_t(names.size());
+            Periodicity per = findPeriod(cellsOf(p), maxPeriod);
+            names.push_back(p.name);
+            for (size_t ph = 0; ph < per.phases.size(); ++ph)
+                table.emplace(fingerprint(per.phases[ph]), Entry{id, uint16_t(ph), uint16_t(per.period)});
+        }
+    }
+
+    const Entry* find(uint64_t fp) const {
+        auto it = table.find(fp);
+        return it == table.end() ? nullptr : &it->second;
+    }
+
+    const std::string& name(const Entry& e) const { return names[e.name]; }
+    size_t             size() const { return table.size(); }
+    size_t             patterns() const { return names.size(); }
+
+    // Binary layout, native endianness: magic, source hash, name count, names
+    // (u32 length + bytes), entry count, entries (u64 fingerprint, u32 name,
+    // u16 phase, u16 period).
+    bool save(const std::string& path, uint64_t sourceHash) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) return false;
+        out.write(kMagic, sizeof(kMagic));
+        put(out, sourceHash);
+        put(out, uint32_t(names.size()));
+        for (const std::string& n : names) {
+            put(out, uint32_t(n.size()));
+            out.write(n.data(), std::streamsize(n.size()));
+        }
+        put(out, uint32_t(table.size()));
+        for (auto& [fp, e] : table) {
+            put(out, fp);
+            put(out, e.name);
+            put(out, e.phase);
+            put(out, e.period);
+        }
+        return bool(out);
+    }
+
+    // False (and the index left empty) if the file is missing, damaged, or was
+    // built from a different patterns file.
+    bool load(const std::string& path, uint64_t sourceHash) {
+        table.clear();
+        names.clear();
+        std::ifstream in(path, std::ios::binary);
+        char          magic[sizeof(kMagic)];
+        uint64_t      hash = 0;
+        uint32_t      count = 0;
+        if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kMagic) || !get(in, hash) ||
+            hash != sourceHash || !get(in, count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t len = 0;
+            if (!get(in, len) || len > 4096) return fail();
+            std::string n(len, '\0');
+            if (!in.read(&n[0], len)) return fail();
+            names.push_back(std::move(n));
+        }
+        if (!get(in, count)) return fail();
+        table.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            uint64_t fp;
+            Entry    e;
+            if (!get(in, fp) || !get(in, e.name) || !get(in, e.phase) || !get(in, e.period) || e.name >= names.size())
+                return fail();
+            table.emplace(fp, e);
+        }
+        return true;
+    }
+
+    // Loads indexPath (default patternsPath + ".idx") if it matches the JSON,
+    // otherwise builds from the JSON and writes it for next time.
+    static PatternIndex open(const std::string& patternsPath, std::string indexPath = "", int maxPeriod = 64) {
+        if (indexPath.empty()) indexPath = patternsPath + ".idx";
+        std::ifstream in(patternsPath, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open pattern file: " + patternsPath);
+        std::string text((std::istreambuf_iterator< char >(in)), std::istreambuf_iterator< char >());
+        uint64_t    hash = 0xcbf29ce484222325ULL ^ uint64_t(maxPeriod);  // FNV-1a
+        for (unsigned char ch : text) hash = (hash ^ ch) * 0x100000001b3ULL;
+
+        PatternIndex index;
+        if (index.load(indexPath, hash)) return index;
+        index.build(loadPatterns(patternsPath), maxPeriod);
+        if (!index.save(indexPath, hash)) std::cerr << "Could not write pattern index " << indexPath << "\n";
+        return index;
+    }
+
+private:
+    static constexpr char kMagic[8] = {'G', 'O', 'L', 'P', 'I', 'D', 'X', '1'};
+
+    std::unordered_map< uint64_t, Entry > table;
+    std::vector< std::string >            names;
+
+    bool fail() {
+        table.clear();
+        names.clear();
+        return false;
+    }
+
+    template < typename T >
+    static void put(std::ofstream& out, T v) {
+        out.write(reinterpret_cast< const char* >(&v), sizeof(v));
+    }
+
+    template < typename T >
+    static bool get(std::ifstream& in, T& v) {
+        return bool(in.read(reinterpret_cast< char* >(&v), sizeof(v)));
+    }
+};
@@ -1,12 +1,56 @@
 #pragma once
 #include <SDL.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
 #include <vector>
 
+#include "./region_counts.hpp"
+
+// What lies past the edge of the board: nothing (always dead), or the opposite
+// edge (a torus).
+enum class Boundary { Dead, Wrap };
+
+inline const char* boundaryName(Boundary b) { return b == Boundary::Wrap ? "wrap" : "dead"; }
+
+inline Boundary parseBoundary(const std::string& s) { return s == "wrap" ? Boundary::Wrap : Boundary::Dead; }
+
+// Rows [top, bottom] x columns [left, right], inclusive; empty when bottom < top.
+struct CellBox {
+    int top = 0, left = 0, bottom = -1, right = -1;
+
+    bool empty() const { return bottom < top; }
+    int  height() const { return empty() ? 0 : bottom - top + 1; }
+    int  width() const { return empty() ? 0 : right - left + 1; }
+
+    void add(int r, int c) {
+        if (empty()) {
+            top = bottom = r;
+            left = right = c;
+            return;
+        }
+        top = std::min(top, r), bottom = std::max(bottom, r);
+        left = std::min(left, c), right = std::max(right, c);
+    }
+};
+
+// What the last generation did, counted by Grid::update() as it went.
+struct GenerationStats {
+    long    population = 0, births = 0, deaths = 0;
+    CellBox box;  // exact bounding box of the live cells
+};
+
 class Grid {
 private:
     int                                rows, cols, cellSize;
-    std::vector< std::vector< bool > > cells;
+    Boundary                           boundary;
+    std::vector< std::vector< bool > > cells, next;  // next: the previous generation, overwritten by update()
+    RegionCounts                       counts;       // packed mirror of cells, for population queries
+    CellBox                            live, stale;  // contain every live cell of cells / next (may be loose)
+    GenerationStats                    stats;
+    std::vector< uint64_t >            scratch;      // one packed row of the new generation
 
     int countNeighbors(int r, int c) {
         int n = 0;
@@ -14,6 +58,10 @@ private:
             for (int dc = -1; dc <= 1; ++dc)
                 if (!(dr == 0 && dc == 0)) {
                     int rr = r + dr, cc = c + dc;
+                    if (boundary == Boundary::Wrap) {
+                        rr = (rr + rows) % rows;
+                        cc = (cc + cols) % cols;
+                    }
                     if (rr >= 0 && rr < rows && cc >= 0 && cc < cols && cells[rr][cc])
                         n++;
                 }
@@ -21,44 +69,143 @@ private:
     }
 
 public:
-    Grid(int width, int height, int cell)
-        : cellSize(cell) {
+    Grid(int width, int height, int cell, Boundary edges = Boundary::Dead)
+        : cellSize(cell), boundary(edges) {
         cols = width / cell;
         rows = height / cell;
         cells.assign(rows, std::vector< bool >(cols, false));
+        next = cells;
+        counts.resize(rows, cols);
+        scratch.resize((cols + 63) / 64);
+    }
+
+    int      rowCount() const { return rows; }
+    int      colCount() const { return cols; }
+    Boundary edges() const { return boundary; }
+
+    // Fills the board with live cells at the given density. Same seed, same board.
+    void randomize(double density, uint64_t seed) {
+        std::mt19937_64             rng(seed);
+        std::bernoulli_distribution coin(density);
+        for (int r = 0; r < rows; ++r)
+            for (int c = 0; c < cols; ++c) {
+                counts.set(r, c, cells[r][c] = coin(rng));
+                if (cells[r][c]) live.add(r, c);
+            }
+    }
+
+    bool isAlive(int row, int col) const { return cells[row][col]; }
+    void setCell(int row, int col, bool alive) {
+        cells[row][col] = alive;
+        counts.set(row, col, alive);
+        if (alive) live.add(row, col);
     }
 
-    void toggleCell(int x, int y) {
+    long population() const { return counts.total(); }
+
+    // Population, births, deaths and bounding box of the last update(). Edits
+    // made since then are not in it.
+    const GenerationStats& lastStats() const { return stats; }
+
+    // Memory held for the board: both generations of cells, the packed mirror and
+    // its tile counts, and the stats scratch row.
+    size_t bytes() const {
+        size_t perRow = (size_t(cols) + 63) / 64 * 8 + sizeof(std::vector< bool >);  // vector<bool>: a bit per cell
+        return 2 * size_t(rows) * perRow + counts.bytes() + scratch.capacity() * sizeof(uint64_t);
+    }
+
+    // Row r at one bit per cell, 64 columns per word (bit i of word w = column 64 * w + i).
+    const uint64_t* packedRow(int r) const { return counts.row(r); }
+
+    // Live cells in rows [row0, row1) x columns [col0, col1), clipped to the
+    // board. Costs about the rectangle's perimeter, not its area.
+    long countLive(int row0, int col0, int row1, int col1) const { return counts.count(row0, col0, row1, col1); }
+
+    // Returns true if (x, y) landed on a cell and it was flipped.
+    bool toggleCell(int x, int y) {
         int col = x / cellSize, row = y / cellSize;
-        if (row >= 0 && row < rows && col >= 0 && col < cols)
-            cells[row][col] = !cells[row][col];
+        if (row < 0 || row >= rows || col < 0 || col >= cols) return false;
+        cells[row][col] = !cells[row][col];
+        counts.set(row, col, cells[row][col]);
+        if (cells[row][col]) live.add(row, col);
+        return true;
     }
 
+    // Only the live bounding box plus a one-cell ring can change, so only that is
+    // visited. On a torus that holds as long as the ring stays off the edges;
+    // otherwise the whole board is. Each new row is packed, then compared with the
+    // packed old row a word at a time for the stats.
     void update() {
-        std::vector< std::vector< bool > > next = cells;
-        for (int r = 0; r < rows; ++r)
-            for (int c = 0; c < cols; ++c) {
+        int r0 = 0, r1 = rows, c0 = 0, c1 = cols;  // region, half-open
+        if (live.empty())
+            r1 = 0;
+        else if (boundary == Boundary::Dead ||
+                 (live.top > 0 && live.left > 0 && live.bottom < rows - 1 && live.right < cols - 1)) {
+            r0 = std::max(0, live.top - 1), r1 = std::min(rows, live.bottom + 2);
+            c0 = std::max(0, live.left - 1), c1 = std::min(cols, live.right + 2);
+        }
+
+        // next still holds the generation before this one; clear what is left of it.
+        for (int r = stale.top; r <= stale.bottom; ++r)
+            std::fill(next[r].begin() + stale.left, next[r].begin() + stale.right + 1, false);
+
+        stats = GenerationStats{};
+        int w0 = c0 / 64, w1 = (c1 + 63) / 64;
+        for (int r = r0; r < r1; ++r) {
+            std::fill(scratch.begin() + w0, scratch.begin() + w1, uint64_t(0));
+            for (int c = c0; c < c1; ++c) {
                 int n = countNeighbors(r, c);
                 if (cells[r][c])
                     next[r][c] = (n == 2 || n == 3);
                 else
                     next[r][c] = (n == 3);
+                scratch[c / 64] |= uint64_t(next[r][c]) << (c % 64);
+            }
+            uint64_t* packed = counts.row(r);
+            for (int w = w0; w < w1; ++w) {
+                uint64_t was = packed[w], now = scratch[w];
+                packed[w] = now;
+                stats.births += __builtin_popcountll(now & ~was);
+                stats.deaths += __builtin_popcountll(was & ~now);
+                if (!now) continue;
+                stats.population += __builtin_popcountll(now);
+                stats.box.add(r, w * 64 + __builtin_ctzll(now));
+                stats.box.add(r, w * 64 + 63 - __builtin_clzll(now));
             }
-        cells = next;
+        }
+        cells.swap(next);
+        stale = live;
+        live = stats.box;
+        counts.rebuild(r0, r1);
     }
 
-    void draw(SDL_Renderer* renderer) {
+    // The draw functions return how many SDL draw calls they issued.
+    int draw(SDL_Renderer* renderer) {
         SDL_SetRenderDrawColor(renderer, 30, 30, 40, 255);
         SDL_RenderClear(renderer);
+        return 1 + drawCells(renderer) + drawLines(renderer);
+    }
+
+    int drawCells(SDL_Renderer* renderer) {
+        int calls = 0;
         SDL_SetRenderDrawColor(renderer, 200, 200, 80, 255);
         for (int r = 0; r < rows; ++r)
             for (int c = 0; c < cols; ++c)
-                if (cells[r][c])
-                    SDL_RenderFillRect(renderer, new SDL_Rect{c * cellSize, r * cellSize, cellSize, cellSize});
+                if (cells[r][c]) {
+                    SDL_Rect rect = {c * cellSize, r * cellSize, cellSize, cellSize};
+                    SDL_RenderFillRect(renderer, &rect);
+                    ++calls;
+                }
+        return calls;
+    }
+
+    int drawLines(SDL_Renderer* renderer) {
+        int calls = 0;
         SDL_SetRenderDrawColor(renderer, 80, 80, 100, 255);
-        for (int x = 0; x <= cols * cellSize; x += cellSize)
+        for (int x = 0; x <= cols * cellSize; x += cellSize, ++calls)
             SDL_RenderDrawLine(renderer, x, 0, x, rows * cellSize);
-        for (int y = 0; y <= rows * cellSize; y += cellSize)
+        for (int y = 0; y <= rows * cellSize; y += cellSize, ++calls)
             SDL_RenderDrawLine(renderer, 0, y, cols * cellSize, y);
+        return calls;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,288 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+#include "../includes/json.hpp"
+#include "../includes/latency_histogram.hpp"
+#include "../includes/perf_counters.hpp"
+#include "../includes/trace_events.hpp"
+#include "./autotune.hpp"
+#include "./components.hpp"
+#include "./fingerprint.hpp"
+#include "./pattern_search.hpp"
+#include "./cycle_detector.hpp"
+#include "./engines.hpp"
+#include "./history.hpp"
+#include "./snapshot.hpp"
+
+using nlohmann::json;
+
+// Runs the simulation with no window and no renderer, as fast as it will go.
+// Meant for CI and batch nodes without a display:
+//
+//     ./main headless=true cols=1024 rows=1024 generations=500 density=0.3 seed=42
+//
+//   cols, rows       board size (default width/height/cell_size, as in the window)
+//   generations      generations to run (default 1000)
+//   density, seed    random soup (default 0.3, 42)
+//   pattern          start from this patterns.json entry instead (patterns_file)
+//   engine, ...      update engine, picked as in the window (see resolveEngine())
+//   batch            generations per stepMany() call (default 8)
+//   cycles           skip whole periods once the board settles (default true);
+//                    cycle_every, max_period, stop_on_cycle
+//   components       split the board into islands every N generations and name
+//                    the final ones (merge_distance, default 1)
+//   find             patterns to search the final board for, e.g. glider+lwss
+//   history_mb       record an N MB rewind history (keyframe_every, seek_ms)
+//   load, save       start from / write a .golsnap snapshot (snapshot_tiles)
+//   trace            Chrome trace_event JSON of the run
+//   perf             hardware counters where available
+//
+// Prints throughput, the final population and whatever the options above add.
+class HeadlessRunner {
+public:
+    explicit HeadlessRunner(const json& params)
+        : generations(params.value("generations", 1000L)),
+          density(params.value("density", 0.3)),
+          seed(params.value("seed", 42ULL)),
+          batch(std::max(1, params.value("batch", 8))),
+          detectCycles(params.value("cycles", true)),
+          stopOnCycle(params.value("stop_on_cycle", false)),
+          maxPeriod(params.value("max_period", 64)),
+          cycleEvery(params.value("cycle_every", 16)),
+          componentsEvery(params.value("components", 0)),
+          mergeDistance(params.value("merge_distance", 1)),
+          findNames(params.value("find", "")),
+          patternName(params.value("pattern", "")),
+          patternsFile(params.value("patterns_file", "../../patterns.json")),
+          tracePath(params.value("trace", "")),
+          savePath(params.value("save", "")),
+          saveTiles(params.value("snapshot_tiles", 64)) {
+        // keyframe_every=0 (the default) fits the keyframe spacing to seek_ms.
+        if (params.value("history_mb", 0) > 0)
+            history = std::make_unique< History >(size_t(params.value("history_mb", 0)) << 20,
+                                                  params.value("keyframe_every", 0), params.value("seek_ms", 2.0));
+        int cols = params.value("cols", params.value("width", 800) / params.value("cell_size", 10));
+        int rows = params.value("rows", params.value("height", 600) / params.value("cell_size", 10));
+        // A snapshot brings its size and boundary unless cols/rows/boundary are
+        // given, and the run carries on from its generation for `generations` more.
+        if (std::string load = params.value("load", ""); !load.empty()) {
+            auto t0 = std::chrono::steady_clock::now();
+            snapshot = std::make_unique< Snapshot >(Snapshot::open(load));
+            std::cout << "Opened " << load << " (" << snapshot->cols() << "x" << snapshot->rows() << ", generation "
+                      << snapshot->generation() << (snapshot->inPlace() ? ", mapped in place" : ", decoded") << ") in "
+                      << std::fixed << std::setprecision(3)
+                      << std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - t0).count()
+                      << " ms\n";
+            cols = params.value("cols", snapshot->cols());
+            rows = params.value("rows", snapshot->rows());
+            startGen = snapshot->generation();
+        }
+        TunedConfig tuned = resolveEngine(params);
+        if (snapshot && !params.contains("boundary")) tuned.cfg.boundary = snapshot->boundary();
+        if (params.value("perf", false) && !perf.open())
+            std::cerr << "Hardware counters unavailable, continuing without them (" << perf.reason() << ")\n";
+        sim = makeEngine(tuned.engine, rows, cols, tuned.cfg);
+        if (!sim) throw std::runtime_error("Unknown engine: " + tuned.engine);
+        cfg = tuned.cfg;
+        if (componentsEvery > 0) labeler = std::make_unique< ComponentLabeler >(cfg.threads);
+    }
+
+    int run() {
+        using Clock = std::chrono::steady_clock;
+        if (snapshot) {
+            snapshot->copyTo(*sim);
+            snapshot.reset();
+        } else if (patternName.empty())
+            seedRandom(*sim, density, seed);
+        else {
+            auto patterns = loadPatterns(patternsFile);
+            auto it = std::find_if(patterns.begin(), patterns.end(), [&](const Pattern& p) { return p.name == patternName; });
+            if (it == patterns.end()) throw std::runtime_error("No pattern named " + patternName + " in " + patternsFile);
+            seedPattern(*sim, *it);
+        }
+        long startPop = sim->population();
+        if (!tracePath.empty()) {
+            Trace::setThreadName("main");
+            Trace::start();
+        }
+
+        LatencyHistogram steps, labels;
+        double           recordSecs = 0;
+        if (history) history->record(*sim, startGen);
+        CycleDetector    cycles(maxPeriod, cycleEvery);
+        bool             detecting = detectCycles;
+        long             g = startGen, end = startGen + generations, stepped = 0, skipped = 0;
+        if (detecting) cycles.observe(g, boardHash(*sim));
+
+        PerfSample p0 = perf.read();
+        auto       t0 = Clock::now();
+        while (g < end) {
+            TRACE_SCOPE("sim.step", "sim");
+            // Fused up to the next generation the cycle detector hashes.
+            int  n = int(std::min< long >(batch, (detecting ? std::min(end, cycles.next(g)) : end) - g));
+            auto s0 = Clock::now();
+            sim->stepMany(n);
+            steps.record(uint64_t(std::chrono::duration_cast< std::chrono::microseconds >(Clock::now() - s0).count()) / n);
+            g += n;
+            stepped += n;
+
+            // One frame per stepMany() call, timed so its cost can be set against stepping.
+            if (history) {
+                auto h0 = Clock::now();
+                history->record(*sim, g);
+                recordSecs += std::chrono::duration< double >(Clock::now() - h0).count();
+            }
+
+            if (labeler && g / componentsEvery != (g - n) / componentsEvery) {
+                TRACE_SCOPE("components", "sim");
+                auto l0 = Clock::now();
+                labeler->label(*sim, mergeDistance, false);
+                labels.record(uint64_t(std::chrono::duration_cast< std::chrono::microseconds >(Clock::now() - l0).count()));
+            }
+
+            if (detecting && g == cycles.next(g) && cycles.observe(g, boardHash(*sim))) {
+                detecting = false;
+                if (stopOnCycle) break;
+                // Whole periods change nothing, so jump over them and step the rest.
+                skipped = (end - g) / cycles.period() * cycles.period();
+                g += skipped;
+            }
+        }
+        double     secs = std::chrono::duration< double >(Clock::now() - t0).count();
+        PerfSample counted = perf.read() - p0;
+
+        double cells = double(sim->rows()) * double(sim->cols());
+        std::cout << std::fixed << std::setprecision(3)
+                  << "Headless: " << sim->cols() << "x" << sim->rows() << " board, " << sim->name()
+                  << " engine (threads=" << cfg.threads << ", tile=" << cfg.tile << ", depth=" << cfg.depth << "), "
+                  << g - startGen << " generations (" << stepped << " stepped) in " << secs << " s\n"
+                  << "  " << (secs > 0 ? stepped / secs : 0.0) << " gens/sec, "
+                  << (secs > 0 ? cells * stepped / secs / 1e6 : 0.0) << " M cell-updates/sec\n"
+                  << "  population " << startPop << " -> " << sim->population() << "\n";
+        if (cycles.settled())
+            std::cout << "  settled at generation " << cycles.start() << ", period " << cycles.period()
+                      << (cycles.period() == 1 ? " (still life)" : "") << ", confirmed at " << cycles.confirmedAt()
+                      << (stopOnCycle ? ", stopped there\n" : ", skipped " + std::to_string(skipped) + " generations\n");
+        else if (detectCycles)
+            std::cout << "  no cycle of period <= " << maxPeriod << " found\n";
+        steps.print(std::cout, "sim.step");
+        if (history) {
+            std::cout << std::setprecision(2) << "  history: generations " << history->first() << ".." << history->last()
+                      << " kept in " << history->bytes() / 1048576.0 << " MB, recording took "
+                      << (secs > recordSecs ? 100 * recordSecs / (secs - recordSecs) : 0.0) << "% of the stepping time\n";
+            // The last generation sits furthest from its keyframe in a full group.
+            BitBoard board;
+            auto     s0 = Clock::now();
+            history->seek(history->last(), board);
+            int every = history->keyframeEvery();
+            std::cout << "  " << (every > 0 ? "keyframe every " + std::to_string(every) + " generations" : "one keyframe")
+                      << ", seek to the last took "
+                      << std::setprecision(3) << std::chrono::duration< double, std::milli >(Clock::now() - s0).count()
+                      << " ms\n";
+        }
+        if (labeler && !labeler->last().empty()) {
+            const auto& objs = labeler->last();
+            auto        biggest = std::max_element(objs.begin(), objs.end(), [](const Component& a, const Component& b) {
+                return a.population < b.population;
+            });
+            std::cout << "  " << objs.size() << " objects at the last count (merge distance " << mergeDistance
+                      << "), largest " << biggest->population << " cells in " << biggest->width() << "x"
+                      << biggest->height() << "\n";
+            labels.print(std::cout, "components");
+            printIdentified();
+        }
+        if (!findNames.empty()) printSearch();
+        // Empty tiles of snapshot_tiles rows (default 64) are left out; 0 writes raw
+        // rows, which load fastest.
+        if (!savePath.empty()) {
+            SnapshotWriter writer;
+            auto           w0 = Clock::now();
+            writer.save(*sim, savePath, g, cfg.boundary, saveTiles);
+            double captured = std::chrono::duration< double, std::milli >(Clock::now() - w0).count();
+            if (writer.wait())
+                std::cout << std::setprecision(3) << "  saved " << savePath << " (engine busy " << captured << " ms, written in "
+                          << std::chrono::duration< double, std::milli >(Clock::now() - w0).count() << " ms)\n";
+        }
+        if (perf.available()) {
+            double updates = cells * stepped;
+            std::cout << std::setprecision(2) << "  IPC " << counted.ipc() << ", per cell update: "
+                      << std::setprecision(5) << counted.l1dMisses / updates << " L1d misses, "
+                      << counted.llcMisses / updates << " LLC misses, " << counted.branchMisses / updates
+                      << " branch misses\n";
+        }
+
+        if (!tracePath.empty()) {
+            Trace::stop();
+            if (Trace::writeJson(tracePath))
+                std::cout << "  wrote " << Trace::eventCount() << " trace events to " << tracePath << "\n";
+            else
+                std::cerr << "Could not write trace: " << tracePath << "\n";
+        }
+        return 0;
+    }
+
+private:
+    // Names every final island small enough to be a library pattern.
+    void printIdentified() {
+        PatternIndex library = PatternIndex::open(patternsFile);
+        std::map< std::string, long > named;
+        for (const Component& c : labeler->label(*sim, mergeDistance))
+            if (c.population <= 4096)
+                if (const PatternIndex::Entry* e = library.find(fingerprint(cellsOf(c)))) ++named[library.name(*e)];
+        if (named.empty()) return;
+        std::cout << "  identified:";
+        for (auto& [name, n] : named) std::cout << " " << n << " " << name;
+        std::cout << "\n";
+    }
+
+    // find=: every copy of the named patterns on the final board.
+    void printSearch() {
+        using Clock = std::chrono::steady_clock;
+        auto          patterns = loadPatterns(patternsFile);
+        PatternSearch search(cfg.threads);
+        for (size_t start = 0; start < findNames.size();) {
+            size_t      end = std::min(findNames.find('+', start), findNames.size());
+            std::string name = findNames.substr(start, end - start);
+            auto it = std::find_if(patterns.begin(), patterns.end(), [&](const Pattern& p) { return p.name == name; });
+            if (it == patterns.end()) throw std::runtime_error("No pattern named " + name + " in " + patternsFile);
+            search.add(*it);
+            start = end + 1;
+        }
+        auto   t0 = Clock::now();
+        auto&  hits = search.find(*sim);
+        double ms = std::chrono::duration< double, std::milli >(Clock::now() - t0).count();
+
+        std::map< int, long > perPattern;
+        for (const SearchHit& h : hits) ++perPattern[h.pattern];
+        std::cout << "  search (" << search.templateCount() << " templates) took " << ms << " ms:";
+        for (auto& [id, n] : perPattern) std::cout << " " << n << " " << search.name(id);
+        std::cout << (hits.empty() ? " nothing\n" : "\n");
+    }
+
+    PerfCounters                        perf;  // perf=true; opened before the engine so pool threads inherit it
+    std::unique_ptr< LifeEngine >       sim;
+    EngineConfig                        cfg;
+    long                                generations;
+    double                              density;
+    uint64_t                            seed;
+    int                                 batch;  // generations per stepMany() call; the histogram is per generation
+    bool                                detectCycles, stopOnCycle;
+    int                                 maxPeriod, cycleEvery;
+    int                                 componentsEvery, mergeDistance;
+    std::unique_ptr< ComponentLabeler > labeler;  // components=N
+    std::unique_ptr< History >          history;  // history_mb=N
+    std::string                         findNames;  // '+'-separated
+    std::string                         patternName, patternsFile;
+    std::string                         tracePath;
+    std::string                         savePath;  // save=
+    int                                 saveTiles;
+    std::unique_ptr< Snapshot >         snapshot;  // load=, until it is copied into the engine
+    long                                startGen = 0;  // the snapshot's generation, 0 without one
+};
@@ -0,0 +1,247 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+#include "./bitboard.hpp"
+#include "./life_engine.hpp"
+
+// The last generations of a run, for stepping backwards and scrubbing.
+//
+//     History history(64 << 20);            // keep at most 64 MB
+//     history.record(*sim, generation);     // after every step or batch, and after edits
+//     history.seek(g, board, shownGen);     // any recorded generation, for display
+//     history.restore(*sim, history.before(generation));
+//
+// Each recorded board is stored as the XOR of its packed board with the one
+// recorded before it, run-length coded by 64-bit words: a header word (zero words
+// to skip in the high half, literal words that follow in the low half), then the
+// literals. Generations need not be consecutive: an engine that fuses several
+// generations per stepMany() call is recorded once per call, and only those
+// generations can be gone back to. Most of a board doesn't change from one step
+// to the next, so a delta is a few words per active area. Every keyframeEvery
+// generations, and whenever the recorded run is broken (edits, rewinds), a
+// keyframe is stored instead: the same coding against an empty board.
+//
+// Going to generation g decodes the last keyframe at or before g and applies the
+// deltas after it, at most keyframeEvery of them. A delta is its own inverse, so
+// when the board at hand is a nearby generation of the same group it is cheaper
+// to apply the deltas in between, in either direction; dragging a timeline moves
+// a few generations per frame. When the history grows past maxBytes the oldest
+// keyframe and its deltas are dropped together.
+//
+// keyframeEvery <= 0 picks the spacing itself: every keyframe is timed as it is
+// decoded once, which gives the cost of a keyframe and of applying one word, and
+// the next keyframe is stored when the deltas since the last one would push a
+// seek past seekMs. Boards that change little get sparse keyframes and save the
+// memory; busy ones get dense keyframes and stay quick to seek.
+//
+// Recording costs one exportRow() per row plus a pass over the packed words, a
+// small fraction of a generation for every engine that steps cell by cell.
+class History {
+public:
+    explicit History(size_t maxBytes = size_t(64) << 20, int keyframeEvery = 64, double seekMs = 2.0)
+        : maxBytes(maxBytes), adaptive(keyframeEvery <= 0), spacing(adaptive ? 0 : keyframeEvery), seekMs(seekMs) {}
+
+    bool   empty() const { return frames.empty(); }
+    long   first() const { return frames.empty() ? -1 : frames.front().generation; }
+    long   last() const { return frames.empty() ? -1 : frames.back().generation; }
+    size_t bytes() const { return stored + (prev.bits.size() + cur.bits.size()) * sizeof(uint64_t); }
+    bool   has(long generation) const { return index(generation) < frames.size(); }
+    int    keyframeEvery() const { return spacing; }  // adaptive: the last spacing used, 0 before there is one
+
+    // The latest recorded generation <= `generation`, or -1 if there is none.
+    long atOrBefore(long generation) const {
+        auto it = upperBound(generation);
+        return it == frames.begin() ? -1 : std::prev(it)->generation;
+    }
+
+    // The latest recorded generation < `generation`, or -1.
+    long before(long generation) const { return atOrBefore(generation - 1); }
+
+    void clear() {
+        frames.clear();
+        stored = 0;
+        keys = 0;
+        prevGen = -1;
+    }
+
+    // Stores the engine's board as `generation`. Anything recorded at or after it,
+    // or after the generation last restored, is forgotten first.
+    void record(const LifeEngine& eng, long generation) {
+        // A delta needs prev to be the last frame: after a restore() it is an older one.
+        bool follows = !frames.empty() && prevGen == last() && generation > prevGen && eng.rows() == prev.rows &&
+                       eng.cols() == prev.cols;
+        if (!follows) {
+            if (eng.rows() != prev.rows || eng.cols() != prev.cols)
+                clear();
+            else
+                truncate(std::min(generation - 1, prevGen));
+        }
+        cur.load(eng);
+
+        // A keyframe when the run is broken, on schedule, or when the oldest group
+        // is the only one left and it is over budget, so it can be let go next time.
+        long run = generation - lastKey;
+        bool due = adaptive ? run >= kMaxSpacing || (run >= kMinSpacing && keyMs + msPerWord * groupWords >= seekMs)
+                            : run >= spacing;
+        bool key = !follows || due || (stored > maxBytes && keys == 1);
+        encode(cur.bits.data(), key ? nullptr : prev.bits.data(), cur.bits.size(), scratch);
+        frames.push_back({generation, key, std::vector< uint64_t >(scratch.begin(), scratch.end())});
+        stored += frames.back().bytes();
+        groupWords += scratch.size();
+        std::swap(prev, cur);
+        prevGen = generation;
+        if (key) {
+            if (adaptive && due) spacing = int(run);
+            lastKey = generation, ++keys;
+            groupWords = 0;
+            if (adaptive) timeKeyframe();
+        }
+
+        while (stored > maxBytes && keys > 1) dropOldestGroup();
+    }
+
+    // The board as it was at `generation`. False if that isn't recorded. If `out`
+    // already holds recorded generation `from`, it may be moved from there.
+    bool seek(long generation, BitBoard& out, long from = -1) const {
+        size_t i = index(generation);
+        if (i >= frames.size()) return false;
+        size_t k = i;
+        while (!frames[k].key) --k;
+        if (has(from) && out.rows == prev.rows && out.cols == prev.cols) {
+            size_t f = index(from);
+            size_t lo = std::min(i, f), hi = std::max(i, f), j = hi;
+            while (j > lo && !frames[j].key) --j;
+            // Deltas lo+1 .. hi turn one into the other, either way round.
+            if (j == lo && hi - lo <= i - k) {
+                for (size_t d = lo + 1; d <= hi; ++d) apply(frames[d].data, out.bits.data());
+                return true;
+            }
+        }
+        out.resize(prev.rows, prev.cols);
+        for (; k <= i; ++k) apply(frames[k].data, out.bits.data());
+        return true;
+    }
+
+    // Puts the engine back to `generation`. Only cells that differ are set().
+    // Later generations stay until the next record() replaces them.
+    bool restore(LifeEngine& eng, long generation) {
+        if (!has(generation) || eng.rows() != prev.rows || eng.cols() != prev.cols) return false;
+        seek(generation, cur);
+        std::vector< uint64_t > row(size_t(cur.words));
+        for (int r = 0; r < cur.rows; ++r) {
+            eng.exportRow(r, row.data());
+            const uint64_t* want = cur.row(r);
+            for (int w = 0; w < cur.words; ++w)
+                for (uint64_t diff = row[w] ^ want[w]; diff; diff &= diff - 1) {
+                    int c = w * 64 + __builtin_ctzll(diff);
+                    eng.set(r, c, want[w] >> (c % 64) & 1);
+                }
+        }
+        std::swap(prev, cur);
+        prevGen = generation;
+        return true;
+    }
+
+private:
+    struct Frame {
+        long                    generation;
+        bool                    key;
+        std::vector< uint64_t > data;
+
+        size_t bytes() const { return sizeof(Frame) + data.capacity() * sizeof(uint64_t); }
+    };
+
+    size_t                  maxBytes;
+    bool                    adaptive;
+    int                     spacing;  // generations per keyframe
+    double                  seekMs;
+    std::deque< Frame >     frames;      // ascending generations, frames.front() is a keyframe
+    size_t                  stored = 0;  // bytes in frames
+    int                     keys = 0;    // keyframes in frames
+    long                    lastKey = 0;
+    BitBoard                prev, cur;   // prev: the last generation recorded (or restored)
+    std::vector< uint64_t > scratch;     // encode() output before it is copied to its exact size
+    double                  keyMs = 0, msPerWord = 0;  // measured by timeKeyframe()
+    size_t                  groupWords = 0;            // in the deltas since the last keyframe
+    long                    prevGen = -1;              // the generation in prev
+
+    static constexpr int kMinSpacing = 4, kMaxSpacing = 1024;
+
+    std::deque< Frame >::const_iterator upperBound(long generation) const {
+        return std::upper_bound(frames.begin(), frames.end(), generation,
+                                [](long g, const Frame& f) { return g < f.generation; });
+    }
+
+    // Position of `generation` in frames, or frames.size() if it isn't recorded.
+    size_t index(long generation) const {
+        auto it = upperBound(generation);
+        if (it == frames.begin() || std::prev(it)->generation != generation) return frames.size();
+        return size_t(std::prev(it) - frames.begin());
+    }
+
+    // Drops frames after `generation`.
+    void truncate(long generation) {
+        while (!frames.empty() && frames.back().generation > generation) {
+            stored -= frames.back().bytes();
+            keys -= frames.back().key;
+            frames.pop_back();
+        }
+        for (auto it = frames.rbegin(); it != frames.rend(); ++it)
+            if (it->key) {
+                lastKey = it->generation;
+                break;
+            }
+    }
+
+    // Times one decode of the keyframe just stored: what a seek pays before the
+    // deltas, and (averaged) what each word of them costs.
+    void timeKeyframe() {
+        const Frame& key = frames.back();
+        auto         t0 = std::chrono::steady_clock::now();
+        cur.resize(prev.rows, prev.cols);  // free until the next record() loads it
+        apply(key.data, cur.bits.data());
+        keyMs = std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - t0).count();
+        double perWord = keyMs / double(std::max< size_t >(1, key.data.size()));
+        msPerWord = msPerWord == 0 ? perWord : msPerWord * 0.8 + perWord * 0.2;
+    }
+
+    void dropOldestGroup() {
+        do {
+            stored -= frames.front().bytes();
+            keys -= frames.front().key;
+            frames.pop_front();
+        } while (!frames.empty() && !frames.front().key);
+    }
+
+    // a XOR b (b = nullptr: a alone) as runs of zero words and literal words.
+    static void encode(const uint64_t* a, const uint64_t* b, size_t n, std::vector< uint64_t >& out) {
+        out.clear();
+        size_t i = 0;
+        while (i < n) {
+            size_t zeros = 0;
+            while (i < n && (b ? a[i] == b[i] : a[i] == 0) && zeros < 0xffffffffu) ++i, ++zeros;
+            size_t header = out.size(), literals = 0;
+            out.push_back(0);
+            while (i < n && (b ? a[i] != b[i] : a[i] != 0) && literals < 0xffffffffu) {
+                out.push_back(b ? a[i] ^ b[i] : a[i]);
+                ++i, ++literals;
+            }
+            out[header] = uint64_t(zeros) << 32 | literals;
+        }
+    }
+
+    static void apply(const std::vector< uint64_t >& data, uint64_t* words) {
+        size_t at = 0;
+        for (size_t i = 0; i < data.size();) {
+            uint64_t header = data[i++];
+            at += header >> 32;
+            for (uint64_t k = header & 0xffffffffu; k > 0; --k) words[at++] ^= data[i++];
+        }
+    }
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "./grid.hpp"
+#include "./patterns.hpp"
+
+// Knobs an update engine may or may not care about.
+struct EngineConfig {
+    int      threads = 1;
+    int      tile = 64;
+    int      depth = 4;  // generations per pass over memory, for temporally blocked engines
+    Boundary boundary = Boundary::Dead;
+    bool     unbounded = false;  // no edges at all (engines that support it)
+};
+
+// A way of stepping a board one generation. Every engine implements the same
+// rules as Grid::update(); the bench, verification and tuning tools drive them
+// all through this interface.
+class LifeEngine {
+public:
+    virtual ~LifeEngine() = default;
+
+    virtual std::string name() const = 0;
+    virtual int         rows() const = 0;
+    virtual int         cols() const = 0;
+    virtual bool        get(int r, int c) const = 0;
+    virtual void        set(int r, int c, bool alive) = 0;
+    virtual void        step() = 0;
+    virtual long        population() const = 0;
+    virtual size_t      bytes() const = 0;  // memory held for the board state
+
+    // Advances n generations. Engines that can do several generations per pass
+    // over the board override this; the result must equal n calls to step().
+    virtual void stepMany(int n) {
+        for (int i = 0; i < n; ++i) step();
+    }
+
+    // Packs row r into 64-cell words, bit i of words[i / 64] = column i. Engines
+    // with a faster way to get at a whole row override this.
+    virtual void exportRow(int r, uint64_t* words) const {
+        int n = (cols() + 63) / 64;
+        for (int w = 0; w < n; ++w) words[w] = 0;
+        for (int c = 0; c < cols(); ++c)
+            if (get(r, c)) words[c / 64] |= uint64_t(1) << (c % 64);
+    }
+
+    // Population, births, deaths and bounding box of the last generation stepped,
+    // from engines that count them while stepping. nullptr from the rest.
+    virtual const GenerationStats* lastStats() const { return nullptr; }
+};
+
+// exportRow() for engines that keep one byte (0 or 1) per cell, row-major. Eight
+// cells at a time: the multiply moves byte i's low bit to bit 56 + i, with no
+// two partial products landing on the same bit, so nothing carries.
+inline void packRow(const uint8_t* cells, int n, uint64_t* words) {
+    for (int w = 0; w * 64 < n; ++w) {
+        uint64_t bits = 0;
+        int      i = 0, end = std::min(64, n - w * 64);
+        for (; i + 8 <= end; i += 8) {
+            uint64_t eight;
+            std::memcpy(&eight, cells + w * 64 + i, 8);
+            bits |= ((eight * 0x0102040810204080ULL) >> 56) << i;
+        }
+        for (; i < end; ++i) bits |= uint64_t(cells[w * 64 + i]) << i;
+        words[w] = bits;
+    }
+}
+
+// 64-bit fingerprint of the whole board (dimensions included). Two engines in the
+// same state always agree; a collision between different states is ~2^-64.
+inline uint64_t boardHash(const LifeEngine& eng) {
+    auto mix = [](uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        return h ^ (h >> 33);
+    };
+    uint64_t                h = mix(uint64_t(eng.rows()) << 32 | uint32_t(eng.cols()));
+    std::vector< uint64_t > row((eng.cols() + 63) / 64);
+    for (int r = 0; r < eng.rows(); ++r) {
+        eng.exportRow(r, row.data());
+        for (uint64_t w : row) h = mix(h ^ w) + 0x9e3779b97f4a7c15ULL;
+    }
+    return h;
+}
+
+// First (row, col) in row-major order where two same-sized boards differ, or
+// {-1, -1} if they are identical.
+inline std::pair< int, int > firstDifference(const LifeEngine& a, const LifeEngine& b) {
+    int                     words = (a.cols() + 63) / 64;
+    std::vector< uint64_t > ra(words), rb(words);
+    for (int r = 0; r < a.rows(); ++r) {
+        a.exportRow(r, ra.data());
+        b.exportRow(r, rb.data());
+        for (int w = 0; w < words; ++w)
+            if (uint64_t d = ra[w] ^ rb[w]) return {r, w * 64 + __builtin_ctzll(d)};
+    }
+    return {-1, -1};
+}
+
+// Seeds -------------------------------------------------------------------
+
+// Random soup over the whole board. Uses the same RNG sequence as Grid::randomize.
+inline void seedRandom(LifeEngine& eng, double density, uint64_t seed) {
+    std::mt19937_64             rng(seed);
+    std::bernoulli_distribution coin(density);
+    for (int r = 0; r < eng.rows(); ++r)
+        for (int c = 0; c < eng.cols(); ++c)
+            if (coin(rng)) eng.set(r, c, true);
+}
+
+// Places a pattern in the middle of an empty board.
+inline void seedPattern(LifeEngine& eng, const Pattern& p) {
+    auto [ox, oy] = centredOrigin(p, eng.rows(), eng.cols());
+    for (auto [x, y] : p.cells) {
+        int r = oy + y, c = ox + x;
+        if (r >= 0 && r < eng.rows() && c >= 0 && c < eng.cols()) eng.set(r, c, true);
+    }
+}
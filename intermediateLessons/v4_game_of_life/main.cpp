@@ -1,11 +1,27 @@
 #include "sdl2_engine.hpp"
 
-int main() {
-    Sdl2Start     sdl("SDL2 Grid Example", 800, 600);
+#include "../includes/argsToJson.hpp"
+#include "census.hpp"
+#include "headless.hpp"
+
+int main(int argc, char* argv[]) {
+    json params = ArgsToJson(argc, argv);
+
+    // No window, no renderer: just run generations and report throughput.
+    if (params.value("headless", false))
+        return HeadlessRunner(params).run();
+
+    // Batch soup search on every core; writes a census of what the soups leave behind.
+    if (params.value("census", false))
+        return CensusRunner(params).run();
+
+    Sdl2Start     sdl(params.value("title", "SDL2 Grid Example"),
+                      params.value("width", 800), params.value("height", 600),
+                      params.value("vsync", false));
     RenderContext context = sdl.init_window();
 
-    GameEngine game(context, 10);
+    GameEngine game(context, params);
     game.run();
 
     return 0;
-}
\ No newline at end of file
+}
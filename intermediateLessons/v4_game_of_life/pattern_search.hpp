@@ -0,0 +1,172 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../includes/thread_pool.hpp"
+#include "./bitboard.hpp"
+#include "./fingerprint.hpp"
+#include "./patterns.hpp"
+
+struct SearchHit {
+    int row, col;  // top-left of the pattern's bounding box on the board
+    int pattern;   // id from PatternSearch::add()
+    int symmetry;  // which image, in shapeOf()'s numbering
+    int phase;     // generations after the shape in patterns.json
+};
+
+// Finds every occurrence of library patterns on a board, in any orientation and
+// (by default) any phase.
+//
+//     PatternSearch search(threads);
+//     search.add(glider);
+//     for (const SearchHit& h : search.find(*sim)) ...
+//
+// A hit is an isolated copy: the pattern's live cells are alive and every other
+// cell of its bounding box, plus a one-cell ring around it, is dead. Cells off
+// the board count as dead.
+//
+// Each distinct image of a pattern (up to 8 symmetries x period phases) becomes a
+// template: a list of (row, col, alive) conditions over the ring-padded box, live
+// cells first. The board is a BitBoard, and a template is tried at 64 columns at
+// once: for each condition take the board word starting at that offset (two
+// shifts and an OR, see BitBoard::window()), AND it into the match mask, or AND
+// its complement for a dead cell, and stop as soon as the mask is empty.
+// Templates with the same box size share a first test, a live cell on every edge
+// of the box, which rules out most words before any template is tried. Bands of
+// rows are searched in parallel.
+class PatternSearch {
+public:
+    explicit PatternSearch(int threads = 1, int bandRows = 64)
+        : bandRows(std::max(1, bandRows)), pool(std::make_unique< ThreadPool >(threads)) {}
+
+    // allPhases: also match the later phases of a pattern that repeats (see
+    // findPeriod()); otherwise only the shape given.
+    int add(const Pattern& p, bool allPhases = true, int maxPeriod = 64) {
+        int                                id = int(names.size());
+        std::vector< std::vector< Cell > > phases = {cellsOf(p)};
+        if (allPhases)
+            if (Periodicity per = findPeriod(phases[0], maxPeriod); per.period > 0) phases = std::move(per.phases);
+        names.push_back(p.name);
+
+        std::vector< Shape > seen;
+        for (int ph = 0; ph < int(phases.size()); ++ph)
+            for (int sym = 0; sym < 8; ++sym) {
+                Shape s = shapeOf(phases[ph], sym);
+                if (std::find(seen.begin(), seen.end(), s) != seen.end()) continue;
+                templates.push_back(makeTemplate(s, id, sym, ph));
+                seen.push_back(std::move(s));
+            }
+
+        std::stable_sort(templates.begin(), templates.end(),
+                         [](const Template& a, const Template& b) { return std::tie(a.h, a.w) < std::tie(b.h, b.w); });
+        groups.clear();
+        for (size_t i = 0; i < templates.size(); ++i)
+            if (groups.empty() || groups.back().h != templates[i].h || groups.back().w != templates[i].w)
+                groups.push_back({templates[i].h, templates[i].w, i, 1});
+            else
+                ++groups.back().count;
+        return id;
+    }
+
+    const std::string& name(int id) const { return names[id]; }
+    size_t             templateCount() const { return templates.size(); }
+
+    // Hits in row-major order of their top-left corner.
+    const std::vector< SearchHit >& find(const LifeEngine& eng) {
+        board.load(eng, pool.get(), bandRows);
+        return find(board);
+    }
+
+    const std::vector< SearchHit >& find(const BitBoard& b) {
+        int bands = (b.rows + bandRows - 1) / bandRows;
+        bandHits.resize(bands);
+        pool->parallelFor(bands, [&](int band) { searchBand(b, band); });
+        hits.clear();
+        for (auto& h : bandHits) hits.insert(hits.end(), h.begin(), h.end());
+        return hits;
+    }
+
+private:
+    struct Cond {
+        int  i, j;  // relative to the box's top-left; -1 and h / w are the ring
+        bool alive;
+    };
+    struct Template {
+        int                 pattern, symmetry, phase;
+        int                 h, w;
+        std::vector< Cond > conds;  // live cells first
+    };
+    struct Group {  // templates [first, first + count) all have an h x w box
+        int    h, w;
+        size_t first, count;
+    };
+
+    int                                     bandRows;
+    std::unique_ptr< ThreadPool >           pool;
+    std::vector< std::string >              names;
+    std::vector< Template >                 templates;  // sorted by box size
+    std::vector< Group >                    groups;
+    BitBoard                                board;
+    std::vector< std::vector< SearchHit > > bandHits;
+    std::vector< SearchHit >                hits;
+
+    static Template makeTemplate(const Shape& s, int pattern, int symmetry, int phase) {
+        Template            t{pattern, symmetry, phase, s.h, s.w, {}};
+        std::vector< Cond > dead;
+        for (int i = -1; i <= s.h; ++i)
+            for (int j = -1; j <= s.w; ++j) {
+                bool inside = i >= 0 && i < s.h && j >= 0 && j < s.w;
+                if (inside && (s.rows[size_t(i) * s.words + j / 64] >> (j % 64) & 1))
+                    t.conds.push_back({i, j, true});
+                else
+                    dead.push_back({i, j, false});
+            }
+        t.conds.insert(t.conds.end(), dead.begin(), dead.end());
+        return t;
+    }
+
+    void searchBand(const BitBoard& b, int band) {
+        std::vector< SearchHit >& out = bandHits[band];
+        out.clear();
+        for (int r = band * bandRows; r < std::min(b.rows, (band + 1) * bandRows); ++r)
+            for (const Group& g : groups) {
+                if (r + g.h > b.rows) continue;
+                for (int w = 0; w < b.words; ++w) {
+                    int c0 = w * 64;
+                    // A bounding box has a live cell on each of its four edges.
+                    uint64_t top = 0, bottom = 0, left = 0, right = 0;
+                    for (int j = 0; j < g.w; ++j) {
+                        top |= b.window(r, c0 + j);
+                        bottom |= b.window(r + g.h - 1, c0 + j);
+                    }
+                    // Only corners that leave room for the whole box on the board.
+                    int      last = b.cols - g.w - c0;
+                    uint64_t candidates = top & bottom & (last < 0 ? 0 : last >= 63 ? ~uint64_t(0) : (uint64_t(1) << (last + 1)) - 1);
+                    if (!candidates) continue;
+                    for (int i = 0; i < g.h; ++i) {
+                        left |= b.window(r + i, c0);
+                        right |= b.window(r + i, c0 + g.w - 1);
+                    }
+                    candidates &= left & right;
+
+                    for (size_t ti = g.first; candidates && ti < g.first + g.count; ++ti) {
+                        const Template& t = templates[ti];
+                        uint64_t        m = candidates;
+                        for (size_t k = 0; m && k < t.conds.size(); ++k) {
+                            uint64_t v = b.window(r + t.conds[k].i, c0 + t.conds[k].j);
+                            m &= t.conds[k].alive ? v : ~v;
+                        }
+                        for (; m; m &= m - 1) out.push_back({r, c0 + __builtin_ctzll(m), t.pattern, t.symmetry, t.phase});
+                    }
+                }
+            }
+        // Templates are tried per word, so order each row's hits by column.
+        std::sort(out.begin(), out.end(), [](const SearchHit& a, const SearchHit& b) {
+            return std::tie(a.row, a.col, a.pattern) < std::tie(b.row, b.col, b.pattern);
+        });
+    }
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../includes/json.hpp"
+
+using nlohmann::json;
+
+// One named seed from patterns.json. Cell offsets are normalised so the
+// top-left live cell's bounding box starts at (0, 0).
+struct Pattern {
+    std::string                          name;
+    int                                  w = 0, h = 0;  // bounding box of the live cells
+    std::vector< std::pair< int, int > > cells;         // (x, y)
+};
+
+// Reads every entry of patterns.json (keeps the file's order).
+inline std::vector< Pattern > loadPatterns(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open pattern file: " + path);
+    nlohmann::ordered_json doc = nlohmann::ordered_json::parse(in);
+
+    std::vector< Pattern > out;
+    for (auto& [name, entry] : doc.items()) {
+        Pattern p;
+        p.name = name;
+        int minX = 1 << 30, minY = 1 << 30, maxX = -(1 << 30), maxY = -(1 << 30);
+        for (auto& c : entry.at("cells")) {
+            int x = c.at("x"), y = c.at("y");
+            p.cells.push_back({x, y});
+            minX = std::min(minX, x), maxX = std::max(maxX, x);
+            minY = std::min(minY, y), maxY = std::max(maxY, y);
+        }
+        if (p.cells.empty()) continue;
+        for (auto& [x, y] : p.cells) x -= minX, y -= minY;
+        p.w = maxX - minX + 1;
+        p.h = maxY - minY + 1;
+        out.push_back(std::move(p));
+    }
+    return out;
+}
+
+// Top-left corner that centres `p` on a rows x cols board.
+inline std::pair< int, int > centredOrigin(const Pattern& p, int rows, int cols) {
+    return {(cols - p.w) / 2, (rows - p.h) / 2};
+}
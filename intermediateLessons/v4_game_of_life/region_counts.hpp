@@ -0,0 +1,132 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Live-cell counts for arbitrary rectangles without scanning them.
+//
+// Keeps a packed copy of the board (one bit per cell, 64 columns per word), the
+// population of every tile (one word wide, tileRows tall) and a summed-area table
+// over the tiles. A query adds up the tiles it covers completely from four table
+// entries, then popcounts the words of the rows and columns it only partly
+// covers, so the cost follows the rectangle's edge, not its area.
+//
+// The owner either writes whole rows and calls rebuild(), or flips single cells
+// with set(), which keeps the tile counts exact. The table is brought up to date
+// on the next query, from the topmost changed tile row down: an edit near the
+// bottom of the board costs a few table rows, not the whole table.
+class RegionCounts {
+public:
+    explicit RegionCounts(int tileRows = 8) : th(std::max(1, tileRows)) {}
+
+    void resize(int r, int c) {
+        rows = r;
+        cols = c;
+        words = (c + 63) / 64;
+        tilesDown = (r + th - 1) / th;
+        bits.assign(size_t(rows) * words, 0);
+        tiles.assign(size_t(tilesDown) * words, 0);
+        sat.assign(size_t(tilesDown + 1) * (words + 1), 0);
+        staleFrom = tilesDown;
+    }
+
+    uint64_t*       row(int r) { return &bits[size_t(r) * words]; }  // rebuild() after writing
+    const uint64_t* row(int r) const { return &bits[size_t(r) * words]; }
+    bool            get(int r, int c) const { return bits[size_t(r) * words + c / 64] >> (c % 64) & 1; }
+
+    void set(int r, int c, bool alive) {
+        uint64_t& w = bits[size_t(r) * words + c / 64];
+        uint64_t  bit = uint64_t(1) << (c % 64);
+        if (bool(w & bit) == alive) return;
+        w ^= bit;
+        tiles[size_t(r / th) * words + c / 64] += alive ? 1 : -1;
+        staleFrom = std::min(staleFrom, r / th);
+    }
+
+    // After rewriting rows [r0, r1) directly (default: all of them): recount the
+    // tiles they touch. The table is updated on the next query.
+    void rebuild(int r0 = 0, int r1 = -1) {
+        if (r1 < 0) r1 = rows;
+        if (r0 >= r1) return;
+        for (int t = r0 / th; t < (r1 + th - 1) / th; ++t)
+            for (int w = 0; w < words; ++w) {
+                int n = 0;
+                for (int r = t * th; r < std::min(rows, (t + 1) * th); ++r) n += __builtin_popcountll(bits[size_t(r) * words + w]);
+                tiles[size_t(t) * words + w] = n;
+            }
+        staleFrom = std::min(staleFrom, r0 / th);
+    }
+
+    size_t bytes() const {
+        return bits.capacity() * sizeof(uint64_t) + tiles.capacity() * sizeof(int) + sat.capacity() * sizeof(long);
+    }
+
+    long total() const {
+        refresh();
+        return sat.back();
+    }
+
+    // Live cells in rows [r0, r1) x columns [c0, c1), clipped to the board.
+    long count(int r0, int c0, int r1, int c1) const {
+        r0 = std::max(r0, 0), c0 = std::max(c0, 0);
+        r1 = std::min(r1, rows), c1 = std::min(c1, cols);
+        if (r0 >= r1 || c0 >= c1) return 0;
+        refresh();
+
+        // Tiles entirely inside: rows [T0, T1) of tiles, words [W0, W1).
+        int T0 = (r0 + th - 1) / th, T1 = r1 / th, W0 = (c0 + 63) / 64, W1 = c1 / 64;
+        if (T0 >= T1 || W0 >= W1) return rowSpan(r0, r1, c0, c1);
+
+        long n = tileSum(T0, W0, T1, W1);
+        n += rowSpan(r0, T0 * th, c0, c1);            // rows above the whole tiles
+        n += rowSpan(T1 * th, r1, c0, c1);            // rows below
+        n += rowSpan(T0 * th, T1 * th, c0, W0 * 64);  // left of them, beside
+        n += rowSpan(T0 * th, T1 * th, W1 * 64, c1);  // right
+        return n;
+    }
+
+private:
+    int                         th;  // rows per tile; tiles are one word wide
+    int                         rows = 0, cols = 0, words = 0, tilesDown = 0;
+    std::vector< uint64_t >     bits;
+    std::vector< int >          tiles;  // tilesDown x words
+    mutable std::vector< long > sat;    // (tilesDown + 1) x (words + 1), inclusive prefix sums
+    mutable int                 staleFrom = 0;  // first tile row whose table rows are out of date
+
+    void refresh() const {
+        if (staleFrom < tilesDown) buildTable();
+    }
+
+    // Table rows above staleFrom only sum tiles above it, so they still hold.
+    void buildTable() const {
+        size_t stride = words + 1;
+        for (int t = staleFrom; t < tilesDown; ++t)
+            for (int w = 0; w < words; ++w)
+                sat[(t + 1) * stride + w + 1] = tiles[size_t(t) * words + w] + sat[t * stride + w + 1] +
+                                                sat[(t + 1) * stride + w] - sat[t * stride + w];
+        staleFrom = tilesDown;
+    }
+
+    long tileSum(int t0, int w0, int t1, int w1) const {
+        size_t stride = words + 1;
+        return sat[t1 * stride + w1] - sat[t0 * stride + w1] - sat[t1 * stride + w0] + sat[t0 * stride + w0];
+    }
+
+    // Popcount of rows [r0, r1) x columns [c0, c1), word by word.
+    long rowSpan(int r0, int r1, int c0, int c1) const {
+        if (r0 >= r1 || c0 >= c1) return 0;
+        int      w0 = c0 / 64, w1 = (c1 - 1) / 64;
+        uint64_t first = ~uint64_t(0) << (c0 % 64), last = ~uint64_t(0) >> (63 - (c1 - 1) % 64);
+        long     n = 0;
+        for (int r = r0; r < r1; ++r) {
+            const uint64_t* p = &bits[size_t(r) * words];
+            if (w0 == w1) {
+                n += __builtin_popcountll(p[w0] & first & last);
+                continue;
+            }
+            n += __builtin_popcountll(p[w0] & first) + __builtin_popcountll(p[w1] & last);
+            for (int w = w0 + 1; w < w1; ++w) n += __builtin_popcountll(p[w]);
+        }
+        return n;
+    }
+};
@@ -1,7 +1,36 @@
 #pragma once
 #include <SDL2/SDL.h>
 
-#include "./grid.hpp"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../includes/alloc_tracker.hpp"
+#include "../includes/frame_limiter.hpp"
+#include "../includes/frame_profiler.hpp"
+#include "../includes/input_latency.hpp"
+#include "../includes/json.hpp"
+#include "../includes/latency_histogram.hpp"
+#include "../includes/perf_counters.hpp"
+#include "../includes/trace_events.hpp"
+#include "./autotune.hpp"
+#include "./cycle_detector.hpp"
+#include "./engines.hpp"
+#include "./history.hpp"
+#include "./snapshot.hpp"
+
+using nlohmann::json;
+
+// Build with -DGOL_PROFILE=0 to compile the per-phase profiler out entirely.
+#ifndef GOL_PROFILE
+#define GOL_PROFILE 1
+#endif
+
+using Profiler = FrameProfiler< GOL_PROFILE != 0 >;
 
 struct RenderContext {
     SDL_Window*   window;
@@ -11,7 +40,7 @@ struct RenderContext {
 
 class Sdl2Start {
 public:
-    Sdl2Start(const std::string& title, int width, int height) {
+    Sdl2Start(const std::string& title, int width, int height, bool vsync = false) {
         if (SDL_Init(SDL_INIT_VIDEO) != 0)
             throw std::runtime_error(std::string("SDL Init Error: ") + SDL_GetError());
         window = SDL_CreateWindow(title.c_str(),
@@ -20,7 +49,9 @@ public:
         if (!window)
             throw std::runtime_error(std::string("Window Error: ") + SDL_GetError());
 
-        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+        Uint32 flags = SDL_RENDERER_ACCELERATED;
+        if (vsync) flags |= SDL_RENDERER_PRESENTVSYNC;
+        renderer = SDL_CreateRenderer(window, -1, flags);
         if (!renderer)
             throw std::runtime_error(std::string("Renderer Error: ") + SDL_GetError());
         context = {window, renderer, width, height};
@@ -42,35 +73,414 @@ private:
 
 class GameEngine {
 private:
-    RenderContext ctx;
-    Grid          grid;
-    bool          running = true;
-    bool          paused = true;
+    static constexpr int kPhases = int(Phase::Count);
+
+    RenderContext                 ctx;
+    int                           cellSize;
+    std::unique_ptr< LifeEngine > sim;  // whichever engine the tuner / arguments picked
+    FrameLimiter                  limiter;
+    Profiler                      prof;
+    LatencyHistogram              frameHist, stepHist;
+    InputLatencyTracker           clicks;
+    double                        stepMs;           // simulation time per generation
+    double                        stepAccum = 0.0;  // frame time not yet spent on generations
+    std::string                   tracePath, histPath;
+    PerfCounters                  perf;  // perf=true: hardware counters around update and draw
+    int                           updatePerfIds[4] = {-1, -1, -1, -1}, drawPerfIds[4] = {-1, -1, -1, -1};
+    bool                          noAlloc[kPhases] = {};  // no_alloc=draw+update: phases that must not allocate
+    Alloc::Counts                 frameAllocs[kPhases], totalAllocs[kPhases];
+    int                           allocIds[kPhases + 1];  // profiler metrics: per phase, then frame bytes
+    int                           statIds[5] = {-1, -1, -1, -1, -1};  // from sim->lastStats(), if it has them
+    CycleDetector                 cycles;
+    bool                          detectCycles;
+    long                          generation = 0;
+    History                       history;  // history_mb=0 turns it off
+    bool                          recording;
+    BitBoard                      view;  // the generation under the timeline handle, while dragging it
+    long                          viewGen = -1;
+    bool                          scrubbing = false;
+    SnapshotWriter                snapshots;  // S saves to snapshotPath in the background
+    std::string                   snapshotPath;
+    int                           snapshotTiles;  // tile height for empty-tile compression, 0 = raw rows
+    Boundary                      edges;
+    std::vector< SDL_Rect >       liveRects;  // reused every frame, see reserveDrawBuffers()
+    std::vector< uint64_t >       rowWords;
+    bool                          running = true;
+    bool                          paused = true;
 
 public:
-    GameEngine(RenderContext c, int cell) : ctx(std::move(c)), grid(ctx.width, ctx.height, cell) {}
+    GameEngine(RenderContext c, const json& params)
+        : ctx(std::move(c)),
+          cellSize(params.value("cell_size", 10)),
+          limiter(params.value("fps", 60.0), params.value("vsync", false)),
+          stepMs(1000.0 / std::max(0.1, params.value("gens_per_sec", 10.0))),
+          cycles(params.value("max_period", 64), params.value("cycle_every", 16)),
+          detectCycles(params.value("cycles", true)),
+          history(size_t(std::max(0, params.value("history_mb", 64))) << 20, params.value("keyframe_every", 0),
+                  params.value("seek_ms", 2.0)),
+          recording(params.value("history_mb", 64) > 0),
+          snapshotPath(params.value("snapshot", "board.golsnap")),
+          snapshotTiles(params.value("snapshot_tiles", 64)) {
+        std::unique_ptr< Snapshot > snap;
+        std::string                 load = params.value("load", "");
+        if (!load.empty()) snap = std::make_unique< Snapshot >(Snapshot::open(load));
+        TunedConfig tuned = resolveEngine(params);
+        if (snap && !params.contains("boundary")) tuned.cfg.boundary = snap->boundary();
+        // Before the engine exists, so its worker threads inherit the counters.
+        if (params.value("perf", false)) {
+            if (perf.open()) {
+                if (!perf.reason().empty()) std::cerr << "Some hardware counters missing (" << perf.reason() << ")\n";
+                addPerfMetrics("update", updatePerfIds);
+                addPerfMetrics("draw", drawPerfIds);
+            } else
+                std::cerr << "Hardware counters unavailable, continuing without them (" << perf.reason() << ")\n";
+        }
+        sim = makeEngine(tuned.engine, ctx.height / cellSize, ctx.width / cellSize, tuned.cfg);
+        if (!sim) throw std::runtime_error("Unknown engine: " + tuned.engine);
+        std::cout << "Engine: " << tuned.engine << " (threads=" << tuned.cfg.threads
+                  << ", tile=" << tuned.cfg.tile << ", depth=" << tuned.cfg.depth << ", boundary=" << boundaryName(tuned.cfg.boundary) << ")\n";
+
+        edges = tuned.cfg.boundary;
+        if (snap) {
+            if (snap->rows() != sim->rows() || snap->cols() != sim->cols())
+                std::cerr << "Snapshot " << load << " is " << snap->cols() << "x" << snap->rows() << ", clipped to the "
+                          << sim->cols() << "x" << sim->rows() << " board\n";
+            snap->copyTo(*sim);
+            generation = snap->generation();
+        }
+
+        reserveDrawBuffers();
+        if (recording) history.record(*sim, generation);
+        if (sim->lastStats()) addStatMetrics();
+        if (Alloc::enabled()) {
+            std::string guarded = params.value("no_alloc", "draw");
+            for (int p = 0; p < kPhases; ++p) {
+                noAlloc[p] = guarded.find(phaseName(Phase(p))) != std::string::npos;
+                allocIds[p] = prof.addMetric(std::string(phaseName(Phase(p))) + "_allocs");
+            }
+            allocIds[kPhases] = prof.addMetric("frame_alloc_bytes");
+            if (params.value("alloc_policy", "log") == "abort") Alloc::setPolicy(Alloc::Policy::Abort);
+        }
+
+        prof.setFontPath(params.value("font", ""));
+        std::string csvPath = params.value("profile_csv", "");
+        if (!csvPath.empty() && !prof.openCsv(csvPath))
+            std::cerr << "Could not open profile CSV: " << csvPath << "\n";
+
+        histPath = params.value("hist_json", "");
+        tracePath = params.value("trace", "");
+        if (!tracePath.empty()) {
+            Trace::setThreadName("main");
+            Trace::start();
+        }
+    }
 
     void handle(SDL_Event& e) {
         if (e.type == SDL_QUIT)
             running = false;
-        else if (e.type == SDL_MOUSEBUTTONDOWN)
-            grid.toggleCell(e.button.x, e.button.y);
+        else if (e.type == SDL_MOUSEBUTTONDOWN && onHandle(e.button.x, e.button.y)) {
+            scrubbing = paused = true;
+            viewGen = -1;
+            scrubTo(e.button.x);
+        }
+        else if (e.type == SDL_MOUSEMOTION && scrubbing)
+            scrubTo(e.motion.x);
+        else if (e.type == SDL_MOUSEBUTTONUP && scrubbing) {
+            // Dropping the handle makes that generation the current one.
+            scrubbing = false;
+            if (viewGen != generation && history.restore(*sim, viewGen)) {
+                generation = viewGen;
+                cycles.reset();
+            }
+        }
+        else if (e.type == SDL_MOUSEBUTTONDOWN) {
+            if (toggleCell(e.button.x, e.button.y)) {
+                clicks.onClick(e.button.timestamp);
+                cycles.reset();  // an edited board is a new run
+                if (recording) history.record(*sim, generation);
+            }
+        }
         else if (e.type == SDL_KEYDOWN) {
             if (e.key.keysym.sym == SDLK_ESCAPE) running = false;
             if (e.key.keysym.sym == SDLK_SPACE) paused = !paused;
+            if (e.key.keysym.sym == SDLK_p) prof.toggleHud();
+            if (e.key.keysym.sym == SDLK_h) printLatency();
+            if (e.key.keysym.sym == SDLK_LEFT || e.key.keysym.sym == SDLK_BACKSPACE) stepBack();
+            if (e.key.keysym.sym == SDLK_s) {
+                snapshots.save(*sim, snapshotPath, generation, edges, snapshotTiles);
+                std::cout << "Saving generation " << generation << " to " << snapshotPath << "\n";
+            }
         }
     }
 
     void run() {
         SDL_Event e;
         while (running) {
-            while (SDL_PollEvent(&e)) handle(e);
-            if (!paused) grid.update();
-            grid.draw(ctx.renderer);
-            SDL_RenderPresent(ctx.renderer);
-            SDL_Delay(100);
+            TRACE_SCOPE("frame", "frame");
+            prof.beginFrame();
+            for (auto& a : frameAllocs) a = {};
+            {
+                TRACE_SCOPE("events", "frame");
+                PhaseScope t(*this, Phase::Events);
+                while (SDL_PollEvent(&e)) handle(e);
+            }
+            // Generations advance on their own clock so the simulation speed does not
+            // depend on the frame rate. At most a few catch-up steps per frame.
+            if (!paused) {
+                TRACE_SCOPE("update", "frame");
+                PhaseScope t(*this, Phase::Update);
+                stepAccum += limiter.lastFrameMs();
+                int steps = std::min(4, int(stepAccum / stepMs));
+                if (steps > 0) {
+                    // One call for all of them, so blocked engines can fuse the generations.
+                    TRACE_SCOPE("sim.step", "sim");
+                    PerfSample p0 = perf.read();
+                    Uint64     t0 = SDL_GetPerformanceCounter();
+                    advance(steps);
+                    stepHist.record((SDL_GetPerformanceCounter() - t0) * 1000000 / SDL_GetPerformanceFrequency() / steps);
+                    reportPerf(updatePerfIds, perf.read() - p0, double(steps) * sim->rows() * sim->cols());
+                    reportStats();
+                    stepAccum -= steps * stepMs;
+                }
+                stepAccum = std::min(stepAccum, stepMs);
+            }
+            {
+                TRACE_SCOPE("draw", "frame");
+                PhaseScope t(*this, Phase::Draw);
+                PerfSample p0 = perf.read();
+                drawBoard();
+                drawTimeline();
+                reportPerf(drawPerfIds, perf.read() - p0, double(sim->rows()) * sim->cols());
+            }
+            {
+                TRACE_SCOPE("hud", "frame");
+                PhaseScope t(*this, Phase::Hud);
+                prof.drawHud(ctx.renderer, limiter.targetMs());
+            }
+            {
+                TRACE_SCOPE("present", "frame");
+                PhaseScope t(*this, Phase::Present);
+                SDL_RenderPresent(ctx.renderer);
+                clicks.onPresent();
+            }
+            if (Alloc::enabled()) reportAllocs();
+            prof.endFrame();
+            limiter.wait();
+            if (limiter.frameCount() > 0) frameHist.recordMs(limiter.lastFrameMs());
+        }
+        limiter.report(std::cout);
+        printLatency();
+        if (Alloc::enabled()) printAllocs();
+        if (!histPath.empty()) {
+            std::ofstream out(histPath);
+            out << json{{"frame", frameHist.toJson()}, {"step", stepHist.toJson()}}.dump(2) << "\n";
+            if (!out) std::cerr << "Could not write histograms: " << histPath << "\n";
         }
+        if (!tracePath.empty()) {
+            Trace::stop();
+            if (Trace::writeJson(tracePath))
+                std::cout << "Wrote " << Trace::eventCount() << " trace events to " << tracePath << "\n";
+            else
+                std::cerr << "Could not write trace: " << tracePath << "\n";
+        }
+        prof.release();  // its HUD texture dies with the renderer
         SDL_DestroyRenderer(ctx.renderer);
         SDL_DestroyWindow(ctx.window);
     }
-};
\ No newline at end of file
+
+    // Everything one phase of the frame is measured with: the profiler timer and,
+    // in GOL_TRACK_ALLOCS builds, allocation counts and the no_alloc= guard.
+    class PhaseScope {
+    public:
+        PhaseScope(GameEngine& g, Phase p)
+            : eng(g), phase(p), timer(g.prof.scope(p)),
+              guard(g.noAlloc[int(p)] ? phaseName(p) : nullptr), start(Alloc::counts()) {}
+        ~PhaseScope() { eng.frameAllocs[int(phase)] += Alloc::counts() - start; }
+
+    private:
+        GameEngine&         eng;
+        Phase               phase;
+        Profiler::Scope     timer;
+        Alloc::NoAllocScope guard;
+        Alloc::Counts       start;
+    };
+
+    // drawBoard() never draws more than a window's worth of cells, so sizing its
+    // buffers once up front keeps the draw phase free of allocations.
+    void reserveDrawBuffers() {
+        int visRows = std::min(sim->rows(), ctx.height / cellSize + 1);
+        int visCols = std::min(sim->cols(), ctx.width / cellSize + 1);
+        liveRects.reserve(size_t(visRows) * visCols);
+        rowWords.resize((sim->cols() + 63) / 64);
+    }
+
+    void reportAllocs() {
+        uint64_t bytes = 0;
+        for (int p = 0; p < kPhases; ++p) {
+            prof.metric(allocIds[p], double(frameAllocs[p].allocs));
+            totalAllocs[p] += frameAllocs[p];
+            bytes += frameAllocs[p].bytes;
+        }
+        prof.metric(allocIds[kPhases], double(bytes));
+    }
+
+    void printAllocs() const {
+        long frames = std::max(1L, limiter.frameCount());
+        std::cout << "Allocations per frame (main thread):\n";
+        for (int p = 0; p < kPhases; ++p)
+            std::cout << "  " << std::left << std::setw(8) << phaseName(Phase(p)) << std::right << std::fixed
+                      << std::setprecision(2) << std::setw(10) << double(totalAllocs[p].allocs) / frames
+                      << " allocs " << std::setw(12) << double(totalAllocs[p].bytes) / frames << " bytes"
+                      << (noAlloc[p] ? "  (no_alloc)" : "") << "\n";
+        std::cout << "  no-alloc violations: " << Alloc::violations() << "\n";
+    }
+
+    // Steps the board in fused stepMany() calls, split where the cycle detector
+    // wants a hash (every cycle_every generations, single ones while it pins a
+    // period down). Once settled a still life is not stepped at all any more.
+    // History records one frame per call.
+    void advance(int steps) {
+        for (int left = steps; left > 0;) {
+            bool detecting = detectCycles && !cycles.settled();
+            if (detecting && cycles.next(generation) == generation) cycles.observe(generation, boardHash(*sim));
+            // Fused up to the next generation the detector samples.
+            int n = detecting ? int(std::min< long >(left, cycles.next(generation) - generation)) : left;
+            if (!detectCycles || cycles.period() != 1) sim->stepMany(n);
+            generation += n;
+            left -= n;
+            if (detecting && generation == cycles.next(generation) && cycles.observe(generation, boardHash(*sim)))
+                std::cout << "Settled at generation " << cycles.start() << " with period " << cycles.period()
+                          << (cycles.period() == 1 ? " (still life, no longer stepped)\n" : "\n");
+        }
+        if (recording) history.record(*sim, generation);
+    }
+
+    // The recorded range as a bar along the bottom of the window, with a handle
+    // at the generation on screen. Dragging the handle seeks (see scrubTo()).
+    SDL_Rect timelineRect() const { return {8, ctx.height - 16, ctx.width - 16, 8}; }
+
+    bool hasTimeline() const { return recording && history.first() < history.last(); }
+
+    SDL_Rect handleRect() const {
+        SDL_Rect t = timelineRect();
+        long     span = history.last() - history.first();
+        long     shown = std::clamp(scrubbing ? viewGen : generation, history.first(), history.last());
+        return {t.x + int((shown - history.first()) * (t.w - 1) / span) - 2, t.y - 3, 5, t.h + 6};
+    }
+
+    // The bar lies over the bottom rows of the board, so only the handle (plus a
+    // couple of pixels either side) is grabbed; clicks anywhere else toggle cells.
+    bool onHandle(int x, int y) const {
+        if (!hasTimeline()) return false;
+        SDL_Rect h = handleRect();
+        return x >= h.x - 2 && x < h.x + h.w + 2 && y >= h.y && y < h.y + h.h;
+    }
+
+    // Shows the generation under x without touching the engine. Moving the handle
+    // a little costs a few deltas, a jump at most a keyframe and its group.
+    void scrubTo(int x) {
+        SDL_Rect t = timelineRect();
+        long     span = history.last() - history.first();
+        long     g = history.atOrBefore(history.first() + std::clamp(long(x - t.x) * span / std::max(1, t.w - 1), 0L, span));
+        if (g != viewGen && history.seek(g, view, viewGen)) viewGen = g;
+    }
+
+    void drawTimeline() {
+        if (!hasTimeline()) return;
+        SDL_Rect t = timelineRect(), handle = handleRect();
+        SDL_SetRenderDrawColor(ctx.renderer, 60, 60, 80, 255);
+        SDL_RenderFillRect(ctx.renderer, &t);
+        SDL_SetRenderDrawColor(ctx.renderer, 230, 230, 240, 255);
+        SDL_RenderFillRect(ctx.renderer, &handle);
+    }
+
+    // Left arrow / Backspace: back to the previous recorded generation (one step,
+    // or one fused batch). Pauses, so the user can keep stepping back.
+    void stepBack() {
+        long g = history.before(generation);
+        if (!recording || g < 0 || !history.restore(*sim, g)) return;
+        generation = g;
+        paused = true;
+        cycles.reset();
+    }
+
+    // Returns true if (x, y) landed on a cell and it was flipped.
+    bool toggleCell(int x, int y) {
+        int col = x / cellSize, row = y / cellSize;
+        if (row < 0 || row >= sim->rows() || col < 0 || col >= sim->cols()) return false;
+        sim->set(row, col, !sim->get(row, col));
+        return true;
+    }
+
+    // Same picture as Grid::draw(), for any engine: live cells of the visible rows go
+    // out as a single SDL_RenderFillRects batch, then the grid lines on top.
+    void drawBoard() {
+        SDL_SetRenderDrawColor(ctx.renderer, 30, 30, 40, 255);
+        SDL_RenderClear(ctx.renderer);
+
+        int visRows = std::min(sim->rows(), ctx.height / cellSize + 1);
+        int visCols = std::min(sim->cols(), ctx.width / cellSize + 1);
+        rowWords.resize((sim->cols() + 63) / 64);
+        liveRects.clear();
+        for (int r = 0; r < visRows; ++r) {
+            if (scrubbing && viewGen >= 0)
+                std::copy_n(view.row(r), rowWords.size(), rowWords.begin());
+            else
+                sim->exportRow(r, rowWords.data());
+            for (int w = 0; w * 64 < visCols; ++w)
+                for (uint64_t bits = rowWords[w]; bits; bits &= bits - 1) {
+                    int c = w * 64 + __builtin_ctzll(bits);
+                    if (c >= visCols) break;
+                    liveRects.push_back({c * cellSize, r * cellSize, cellSize, cellSize});
+                }
+        }
+        SDL_SetRenderDrawColor(ctx.renderer, 200, 200, 80, 255);
+        SDL_RenderFillRects(ctx.renderer, liveRects.data(), int(liveRects.size()));
+
+        int w = visCols * cellSize, h = visRows * cellSize;
+        SDL_SetRenderDrawColor(ctx.renderer, 80, 80, 100, 255);
+        for (int x = 0; x <= w; x += cellSize)
+            SDL_RenderDrawLine(ctx.renderer, x, 0, x, h);
+        for (int y = 0; y <= h; y += cellSize)
+            SDL_RenderDrawLine(ctx.renderer, 0, y, w, y);
+    }
+
+    // Population, births, deaths and the live bounding box of the latest generation,
+    // as profiler metrics. The engine counted them while stepping, so this is free.
+    void addStatMetrics() {
+        const char* names[5] = {"population", "births", "deaths", "bbox_w", "bbox_h"};
+        for (int i = 0; i < 5; ++i) statIds[i] = prof.addMetric(names[i]);
+    }
+
+    void reportStats() {
+        const GenerationStats* s = sim->lastStats();
+        if (!s) return;
+        prof.metric(statIds[0], double(s->population));
+        prof.metric(statIds[1], double(s->births));
+        prof.metric(statIds[2], double(s->deaths));
+        prof.metric(statIds[3], double(s->box.width()));
+        prof.metric(statIds[4], double(s->box.height()));
+    }
+
+    // IPC plus L1d / LLC / branch misses per cell, as profiler metrics (HUD + CSV).
+    void addPerfMetrics(const std::string& phase, int ids[4]) {
+        ids[0] = prof.addMetric(phase + "_ipc");
+        ids[1] = prof.addMetric(phase + "_l1d_miss_per_cell");
+        ids[2] = prof.addMetric(phase + "_llc_miss_per_cell");
+        ids[3] = prof.addMetric(phase + "_br_miss_per_cell");
+    }
+
+    void reportPerf(const int ids[4], const PerfSample& d, double cells) {
+        if (!perf.available()) return;
+        prof.metric(ids[0], d.ipc());
+        prof.metric(ids[1], d.l1dMisses / cells);
+        prof.metric(ids[2], d.llcMisses / cells);
+        prof.metric(ids[3], d.branchMisses / cells);
+    }
+
+    void printLatency() const {
+        frameHist.print(std::cout, "frame");
+        stepHist.print(std::cout, "sim.step");
+        clicks.print(std::cout);
+    }
+};
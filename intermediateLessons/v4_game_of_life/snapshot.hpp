@@ -0,0 +1,280 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GOL_SNAPSHOT_MMAP 1
+#else
+#define GOL_SNAPSHOT_MMAP 0
+#endif
+
+#include "./bitboard.hpp"
+#include "./life_engine.hpp"
+
+// A board on disk, for boards too big for anything text based.
+//
+// Layout (native endianness): a 64-byte SnapshotHeader, then the payload.
+// Uncompressed, the payload is the rows at one bit per cell, `words` 64-bit words
+// per row, exactly as exportRow() packs them. Compressed (kTileRle), the board is
+// cut into tiles one word wide and tileRows tall, taken row of tiles by row of
+// tiles, and stored as runs: a header word (empty tiles to skip in the high half,
+// stored tiles that follow in the low half), then each stored tile's words. The
+// payload starts on an 8-byte boundary, so an uncompressed file mapped into
+// memory can be read as rows where it lies.
+struct SnapshotHeader {
+    char     magic[8];  // "GOLSNAP" + '\0'
+    uint32_t version;   // kSnapshotVersion
+    uint32_t flags;     // kTileRle
+    uint32_t rows, cols;
+    uint16_t birth;     // rule: bit n set = born with n neighbours (B3 = 1 << 3)
+    uint16_t survive;   // bit n set = survives with n (S23 = 1 << 2 | 1 << 3)
+    uint8_t  boundary;  // Boundary
+    uint8_t  pad[3];
+    uint32_t tileRows;  // compressed only
+    int64_t  generation;
+    uint64_t payloadBytes;
+    uint8_t  reserved[8];
+};
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header must stay 64 bytes");
+
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr uint32_t kTileRle = 1;
+constexpr uint16_t kLifeBirth = 1 << 3, kLifeSurvive = 1 << 2 | 1 << 3;  // the only rule the engines implement
+
+// Writes `board` to `path` (through path + ".tmp", renamed when complete, so a
+// reader never sees half a file). tileRows > 0 compresses empty tiles away.
+inline void writeSnapshot(const std::string& path, const BitBoard& board, long generation, Boundary boundary,
+                          int tileRows = 0) {
+    SnapshotHeader h{};
+    std::memcpy(h.magic, "GOLSNAP", 8);
+    h.version = kSnapshotVersion;
+    h.flags = tileRows > 0 ? kTileRle : 0;
+    h.rows = uint32_t(board.rows);
+    h.cols = uint32_t(board.cols);
+    h.birth = kLifeBirth;
+    h.survive = kLifeSurvive;
+    h.boundary = uint8_t(boundary);
+    h.tileRows = uint32_t(std::max(0, tileRows));
+    h.generation = generation;
+
+    std::vector< uint64_t > packed;  // compressed payload
+    if (tileRows > 0) {
+        auto tileEmpty = [&](int t, int w) {
+            for (int r = t * tileRows; r < std::min(board.rows, (t + 1) * tileRows); ++r)
+                if (board.row(r)[w]) return false;
+            return true;
+        };
+        int    tilesDown = (board.rows + tileRows - 1) / tileRows;
+        size_t n = size_t(tilesDown) * board.words, i = 0;
+        while (i < n) {
+            size_t empty = 0, stored = 0;
+            while (i < n && empty < 0xffffffffu && tileEmpty(int(i / board.words), int(i % board.words))) ++i, ++empty;
+            size_t header = packed.size();
+            packed.push_back(0);
+            while (i < n && stored < 0xffffffffu && !tileEmpty(int(i / board.words), int(i % board.words))) {
+                int t = int(i / board.words), w = int(i % board.words);
+                for (int r = t * tileRows; r < std::min(board.rows, (t + 1) * tileRows); ++r) packed.push_back(board.row(r)[w]);
+                ++i, ++stored;
+            }
+            packed[header] = uint64_t(empty) << 32 | stored;
+        }
+        h.payloadBytes = packed.size() * sizeof(uint64_t);
+    } else
+        h.payloadBytes = board.bits.size() * sizeof(uint64_t);
+
+    std::string   tmp = path + ".tmp";
+    std::ofstream out(tmp, std::ios::binary);
+    if (!out) throw std::runtime_error("Cannot write snapshot: " + tmp);
+    out.write(reinterpret_cast< const char* >(&h), sizeof(h));
+    const std::vector< uint64_t >& payload = tileRows > 0 ? packed : board.bits;
+    out.write(reinterpret_cast< const char* >(payload.data()), std::streamsize(h.payloadBytes));
+    out.close();
+    if (!out || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("Cannot write snapshot: " + path);
+    }
+}
+
+// A snapshot file opened for reading. The file is mapped, not read: an
+// uncompressed snapshot's rows are used where they lie in the mapping, so opening
+// one costs the same at any size and pages come in as rows are touched. A
+// compressed one is decoded into memory.
+//
+//     Snapshot snap = Snapshot::open("board.golsnap");
+//     auto sim = makeEngine(name, snap.rows(), snap.cols(), cfg);
+//     snap.copyTo(*sim);
+class Snapshot {
+public:
+    Snapshot() = default;
+    Snapshot(Snapshot&& o) noexcept { *this = std::move(o); }
+    Snapshot& operator=(Snapshot&& o) noexcept {
+        std::swap(map, o.map);
+        std::swap(mapBytes, o.mapBytes);
+        std::swap(h, o.h);
+        std::swap(rowsAt, o.rowsAt);
+        std::swap(decoded, o.decoded);
+        std::swap(fileCopy, o.fileCopy);
+        return *this;
+    }
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+    ~Snapshot() { unmap(); }
+
+    // Throws if the file is missing, damaged, from a newer version, or for a
+    // rule other than B3/S23.
+    static Snapshot open(const std::string& path) {
+        Snapshot s;
+        s.mapFile(path);
+        if (s.mapBytes < sizeof(SnapshotHeader)) throw std::runtime_error("Not a snapshot: " + path);
+        std::memcpy(&s.h, s.map, sizeof(SnapshotHeader));
+        if (std::memcmp(s.h.magic, "GOLSNAP", 8) != 0) throw std::runtime_error("Not a snapshot: " + path);
+        if (s.h.version == 0 || s.h.version > kSnapshotVersion)
+            throw std::runtime_error("Snapshot " + path + " is version " + std::to_string(s.h.version) +
+                                     ", this build reads up to " + std::to_string(kSnapshotVersion));
+        if (s.h.birth != kLifeBirth || s.h.survive != kLifeSurvive)
+            throw std::runtime_error("Snapshot " + path + " uses a rule other than B3/S23");
+        if (s.h.boundary > uint8_t(Boundary::Wrap)) throw std::runtime_error("Snapshot damaged: " + path);
+
+        size_t          words = (size_t(s.h.cols) + 63) / 64;
+        const uint64_t* payload = reinterpret_cast< const uint64_t* >(s.map + sizeof(SnapshotHeader));
+        if (s.mapBytes - sizeof(SnapshotHeader) < s.h.payloadBytes) throw std::runtime_error("Snapshot truncated: " + path);
+        if (!(s.h.flags & kTileRle)) {
+            if (s.h.payloadBytes != size_t(s.h.rows) * words * sizeof(uint64_t))
+                throw std::runtime_error("Snapshot damaged: " + path);
+            s.rowsAt = payload;
+            return s;
+        }
+
+        // Compressed: runs of empty and stored tiles into a zeroed board.
+        s.decoded.assign(size_t(s.h.rows) * words, 0);
+        size_t th = std::max< uint32_t >(1, s.h.tileRows), n = s.h.payloadBytes / sizeof(uint64_t);
+        size_t tiles = (s.h.rows + th - 1) / th * words, at = 0;
+        for (size_t i = 0; i < n;) {
+            uint64_t header = payload[i++];
+            at += header >> 32;
+            for (uint64_t k = header & 0xffffffffu; k > 0; --k, ++at) {
+                if (at >= tiles) throw std::runtime_error("Snapshot damaged: " + path);
+                size_t r0 = at / words * th, w = at % words, r1 = std::min< size_t >(s.h.rows, r0 + th);
+                if (i + (r1 - r0) > n) throw std::runtime_error("Snapshot damaged: " + path);
+                for (size_t r = r0; r < r1; ++r) s.decoded[r * words + w] = payload[i++];
+            }
+        }
+        s.rowsAt = s.decoded.data();
+        s.unmap();  // everything needed is in `decoded` now
+        return s;
+    }
+
+    int      rows() const { return int(h.rows); }
+    int      cols() const { return int(h.cols); }
+    int      words() const { return (cols() + 63) / 64; }
+    long     generation() const { return long(h.generation); }
+    Boundary boundary() const { return Boundary(h.boundary); }
+    bool     compressed() const { return h.flags & kTileRle; }
+    bool     inPlace() const { return rowsAt && decoded.empty(); }  // rows read straight from the mapping
+
+    const uint64_t* row(int r) const { return rowsAt + size_t(r) * words(); }
+
+    // Sets the live cells into an engine, clipped to its size. The engine should
+    // start empty.
+    void copyTo(LifeEngine& eng) const {
+        int n = std::min(rows(), eng.rows()), w1 = (std::min(cols(), eng.cols()) + 63) / 64;
+        for (int r = 0; r < n; ++r)
+            for (int w = 0; w < w1; ++w)
+                for (uint64_t bits = row(r)[w]; bits; bits &= bits - 1) {
+                    int c = w * 64 + __builtin_ctzll(bits);
+                    if (c < eng.cols()) eng.set(r, c, true);
+                }
+    }
+
+private:
+    const char*             map = nullptr;
+    size_t                  mapBytes = 0;
+    SnapshotHeader          h{};
+    const uint64_t*         rowsAt = nullptr;
+    std::vector< uint64_t > decoded;   // compressed snapshots only
+    std::vector< char >     fileCopy;  // the "mapping" where there is no mmap
+
+    void mapFile(const std::string& path) {
+#if GOL_SNAPSHOT_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open snapshot: " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot open snapshot: " + path);
+        }
+        void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // the mapping keeps the file
+        if (p == MAP_FAILED) throw std::runtime_error("Cannot map snapshot: " + path);
+        map = static_cast< const char* >(p);
+        mapBytes = size_t(st.st_size);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open snapshot: " + path);
+        fileCopy.assign(std::istreambuf_iterator< char >(in), std::istreambuf_iterator< char >());
+        map = fileCopy.data();
+        mapBytes = fileCopy.size();
+#endif
+    }
+
+    void unmap() {
+#if GOL_SNAPSHOT_MMAP
+        if (map) munmap(const_cast< char* >(map), mapBytes);
+#endif
+        fileCopy.clear();
+        map = nullptr;
+        mapBytes = 0;
+    }
+};
+
+// Saves on a background thread, so the simulation carries on while the file is
+// written. save() takes the copy the writer works from: one exportRow() pass into
+// a packed board, an eighth of a byte-per-cell engine's memory, after which the
+// engine is free to step again. The writer holds the only reference to that
+// board; the next save() waits for it to finish and takes a new one.
+class SnapshotWriter {
+public:
+    SnapshotWriter() = default;
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+    ~SnapshotWriter() { wait(); }
+
+    void save(const LifeEngine& eng, const std::string& path, long generation, Boundary boundary, int tileRows = 0) {
+        wait();
+        auto board = std::make_shared< BitBoard >();
+        board->load(eng);
+        ok = false;
+        worker = std::thread([this, board, path, generation, boundary, tileRows] {
+            try {
+                writeSnapshot(path, *board, generation, boundary, tileRows);
+                ok = true;
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << "\n";
+            }
+        });
+    }
+
+    // Blocks until the save in flight (if any) is done. False if it failed.
+    bool wait() {
+        if (worker.joinable()) worker.join();
+        return ok;
+    }
+
+private:
+    std::thread worker;
+    bool        ok = false;
+};
@@ -0,0 +1,227 @@
+// =============================================================
+// verify_engines.cpp - Bit-exact check of every engine against Grid::update()
+// =============================================================
+// Compile (macOS example):
+// g++ -std=c++17 -O2 verify_engines.cpp -o verify_engines -I/opt/homebrew/include/SDL2 -L/opt/homebrew/lib -lSDL2
+//
+// Run (all arguments optional):
+// ./verify_engines rows=96 cols=130 generations=200 soups=4 threads=1,2,4 tiles=13,64 depths=1,3,4
+//
+//   engines     one engine name, default every registered engine but the reference
+//   boundary    dead, wrap or both (default both)
+//   soups       number of random soups (seeds 1..soups) at density 35%
+//   patterns    also run every patterns.json entry (default true)
+//   history     also check the rewind history (default true)
+//
+// Every engine is run from the same seeds as the reference for `generations` steps,
+// for every combination of thread count, tile size, blocking depth (engines that
+// have one) and boundary mode. Engines are advanced with stepMany() in chunks of
+// 1..7 generations, so multi-generation passes that straddle chunk boundaries are
+// exercised too; the 64-bit board hashes are compared after every chunk. A chunk
+// that ends wrong is replayed from the last generation that matched one step()
+// at a time, and the first divergent generation and cell are printed. Exit status is the number of failing
+// cases (0 = all engines agree).
+//
+// The history check records every seed's run in batches of 1..4 generations,
+// stepping back a few times along the way and carrying on from there, and checks
+// that every generation still recorded seeks back to the board it was.
+// =============================================================
+
+#include "engines.hpp"
+#include "history.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../includes/argsToJson.hpp"
+
+using namespace std;
+
+static vector< int > intList(const json& params, const string& key, vector< int > fallback) {
+    if (!params.contains(key)) return fallback;
+    if (params[key].is_array()) return params[key].get< vector< int > >();
+    return {params[key].get< int >()};
+}
+
+struct Seed {
+    string         name;
+    uint64_t       rng = 0;
+    const Pattern* pattern = nullptr;
+
+    void apply(LifeEngine& eng) const {
+        if (pattern)
+            seedPattern(eng, *pattern);
+        else
+            seedRandom(eng, 0.35, rng);
+    }
+};
+
+// Records a run with rewinds; false on the first generation that seeks back wrong.
+static bool historyMatches(int rows, int cols, const EngineConfig& cfg, const Seed& seed, int gens, int keyframeEvery,
+                           long& bad) {
+    ReferenceEngine eng(rows, cols, cfg);
+    seed.apply(eng);
+    History            history(size_t(64) << 20, keyframeEvery);
+    vector< BitBoard > truth(size_t(gens) + 1);
+    BitBoard           board;
+    long               g = 0;
+    truth[0].load(eng);
+    history.record(eng, 0);
+    for (int batch = 0; g < gens; ++batch) {
+        // Every fifth batch first goes back one or two recorded generations.
+        for (int back = batch % 5 == 4 ? batch % 2 + 1 : 0; back > 0; --back) {
+            long to = history.before(g);
+            if (to < 0 || !history.restore(eng, to)) break;
+            g = to;
+        }
+        int n = int(min< long >(batch % 4 + 1, gens - g));
+        eng.stepMany(n);
+        g += n;
+        truth[size_t(g)].load(eng);
+        history.record(eng, g);
+        if (!history.seek(g, board) || board.bits != truth[size_t(g)].bits) return bad = g, false;
+    }
+    for (long f = history.first(); f <= history.last(); ++f)
+        if (history.has(f) && (!history.seek(f, board) || board.bits != truth[size_t(f)].bits)) return bad = f, false;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    json params = ArgsToJson(argc, argv);
+
+    int    rows = params.value("rows", 96);
+    int    cols = params.value("cols", 130);  // deliberately not a multiple of 64
+    int    gens = params.value("generations", 200);
+    string only = params.value("engines", "all");
+    string edges = params.value("boundary", "both");
+
+    int           hw = max(1, int(thread::hardware_concurrency()));
+    vector< int > threads = intList(params, "threads", {1, 2, 4, hw});
+    vector< int > tiles = intList(params, "tiles", {13, 64});
+    vector< int > depths = intList(params, "depths", {1, 3, 4});
+
+    vector< Boundary > boundaries;
+    if (edges != "wrap") boundaries.push_back(Boundary::Dead);
+    if (edges != "dead") boundaries.push_back(Boundary::Wrap);
+
+    vector< Pattern > patterns;
+    if (params.value("patterns", true))
+        patterns = loadPatterns(params.value("patterns_file", "../../patterns.json"));
+
+    vector< Seed > seeds;
+    for (int s = 1; s <= params.value("soups", 4); ++s) seeds.push_back({"soup_" + to_string(s), uint64_t(s), nullptr});
+    for (auto& p : patterns) seeds.push_back({p.name, 0, &p});
+
+    int cases = 0, failures = 0;
+    for (Boundary b : boundaries)
+        for (auto& seed : seeds) {
+            EngineConfig refCfg;
+            refCfg.boundary = b;
+
+            // Reference hashes for every generation, computed once per seed.
+            vector< uint64_t > expected;
+            {
+                ReferenceEngine ref(rows, cols, refCfg);
+                seed.apply(ref);
+                expected.push_back(boardHash(ref));
+                for (int g = 1; g <= gens; ++g) {
+                    ref.step();
+                    expected.push_back(boardHash(ref));
+                }
+            }
+
+            for (auto& info : engineRegistry()) {
+                if (info.name == "reference" || (only != "all" && only != info.name)) continue;
+                // Only sweep the knobs the engine actually has.
+                vector< int > engineThreads = info.knobs & EngineInfo::kThreads ? threads : vector< int >{1};
+                vector< int > engineTiles = info.knobs & EngineInfo::kTile ? tiles : vector< int >{refCfg.tile};
+                vector< int > engineDepths = info.knobs & EngineInfo::kDepth ? depths : vector< int >{refCfg.depth};
+                for (int t : engineThreads)
+                    for (int tile : engineTiles)
+                        for (int depth : engineDepths) {
+                            EngineConfig cfg = refCfg;
+                            cfg.threads = t;
+                            cfg.tile = tile;
+                            cfg.depth = depth;
+                            // A fresh engine stepped to `to` in the same chunks as the check.
+                            auto runTo = [&](int to) {
+                                auto eng = info.make(rows, cols, cfg);
+                                seed.apply(*eng);
+                                for (int g = 0, chunk = 1; g < to; chunk = chunk % 7 + 1) {
+                                    int n = min(chunk, to - g);
+                                    eng->stepMany(n);
+                                    g += n;
+                                }
+                                return eng;
+                            };
+                            auto eng = runTo(0);
+                            ++cases;
+
+                            int good = 0, bad = boardHash(*eng) != expected[0] ? 0 : -1;
+                            for (int g = 0, chunk = 1; g < gens && bad < 0; chunk = chunk % 7 + 1) {
+                                int n = min(chunk, gens - g);
+                                eng->stepMany(n);
+                                g += n;
+                                if (boardHash(*eng) != expected[g])
+                                    bad = g;
+                                else
+                                    good = g;
+                            }
+                            if (bad < 0) continue;
+
+                            // The chunk ending at `bad` went wrong somewhere after `good`: go
+                            // back there and single-step to the first generation that differs.
+                            // If single steps all agree, only the fused chunk is wrong.
+                            bool fusedOnly = false;
+                            if (bad > 0) {
+                                int chunkEnd = bad;
+                                eng = runTo(good);
+                                for (bad = good; bad < chunkEnd;) {
+                                    eng->step();
+                                    if (boardHash(*eng) != expected[++bad]) break;
+                                }
+                                if (boardHash(*eng) == expected[bad]) {
+                                    fusedOnly = true;
+                                    eng = runTo(chunkEnd);
+                                }
+                            }
+
+                            // Replay the reference to the bad generation to find the cell.
+                            ReferenceEngine ref(rows, cols, refCfg);
+                            seed.apply(ref);
+                            for (int g = 0; g < bad; ++g) ref.step();
+                            auto [r, c] = firstDifference(ref, *eng);
+
+                            ++failures;
+                            cout << "FAIL " << info.name << " threads=" << t << " tile=" << tile << " depth=" << depth
+                                 << " boundary=" << boundaryName(b) << " seed=" << seed.name
+                                 << ": boards differ at generation " << bad << ", cell (row " << r
+                                 << ", col " << c << ") reference=" << ref.get(r, c)
+                                 << " engine=" << eng->get(r, c)
+                                 << (fusedOnly ? " (only when stepMany() fuses generations " + to_string(good + 1) +
+                                                     ".." + to_string(bad) + ")\n"
+                                               : "\n");
+                        }
+            }
+        }
+
+    if (params.value("history", true))
+        for (Boundary b : boundaries)
+            for (auto& seed : seeds)
+                for (int every : {0, 8}) {
+                    EngineConfig cfg;
+                    cfg.boundary = b;
+                    long bad = -1;
+                    ++cases;
+                    if (historyMatches(rows, cols, cfg, seed, gens, every, bad)) continue;
+                    ++failures;
+                    cout << "FAIL history keyframe_every=" << every << " boundary=" << boundaryName(b)
+                         << " seed=" << seed.name << ": generation " << bad << " seeks back to a different board\n";
+                }
+
+    cout << (failures ? "FAILED: " : "OK: ") << cases - failures << "/" << cases << " cases match the reference over "
+         << gens << " generations on a " << cols << "x" << rows << " board\n";
+    return failures;
+}